@@ -0,0 +1,160 @@
+/*
+	Host test: Atomic read-modify-write requests (see muComCore::modify()).
+	Every operation is applied to variables of all operand sizes linked at a device and the previous values returned as well as
+	the new values of the variables are checked. Invalid requests have to be rejected by the device with MUCOM_ERR right away
+	instead of running into the read timeout.
+*/
+
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "muComPosix.h"
+
+
+#define TIMEOUT		1000	//Read timeout in ms. Rejected requests must fail much faster
+
+//Variables linked to the device side interface
+uint32_t Counter = 0;		//Index 0
+uint16_t Flags = 0;			//Index 1
+int8_t Level = 0;			//Index 2
+int32_t Position = 0;		//Index 3
+
+static volatile int Running = 1;
+
+typedef muComStatic<muComPosixTransport, 4, 0> DeviceInterface;
+
+
+void *deviceThread(void *arg)
+{
+	DeviceInterface *device = (DeviceInterface*)arg;
+
+	while(Running)
+	{
+		device->handle();
+		usleep(50);
+	}
+	return NULL;
+}
+
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+//Compare the result of a request with the expected previous and new value
+static int check(const char *name, int8_t ret, long prev, long expectedPrev, long value, long expectedValue)
+{
+	if((ret != MUCOM_OK) || (prev != expectedPrev) || (value != expectedValue))
+	{
+		printf("%-14s FAILED: returned %d, previous %ld (expected %ld), value %ld (expected %ld)\n", name, ret, prev, expectedPrev, value, expectedValue);
+		return 1;
+	}
+	printf("%-14s previous %ld, value %ld\n", name, prev, value);
+	return 0;
+}
+
+
+//Invalid requests must be rejected without waiting for the timeout
+static int checkRejected(const char *name, int8_t ret, double duration)
+{
+	if((ret != MUCOM_ERR) || (duration > TIMEOUT * 1e-3 / 2))
+	{
+		printf("%-14s FAILED: returned %d after %.1f ms\n", name, ret, duration * 1e3);
+		return 1;
+	}
+	printf("%-14s rejected after %.1f ms\n", name, duration * 1e3);
+	return 0;
+}
+
+
+int main(void)
+{
+	int fdDevice, fdHost;
+	pthread_t thread;
+	uint32_t counter;
+	uint16_t flags;
+	int8_t level;
+	int32_t position;
+	int errors = 0;
+	int8_t ret;
+	double start;
+
+	if(muComPosix::openSocketPair(&fdDevice, &fdHost) != MUCOM_OK)
+	{
+		perror("socketpair");
+		return 1;
+	}
+
+	DeviceInterface Device(fdDevice);
+	MUCOM_POSIX_CREATE(Host, fdHost, 0, 0);
+
+	Device.linkVariable(0, &Counter);
+	Device.linkVariable(1, &Flags);
+	Device.linkVariable(2, &Level);
+	Device.linkVariable(3, &Position);
+	Host.setTimeout(TIMEOUT);
+
+	pthread_create(&thread, NULL, deviceThread, &Device);
+
+	//MUCOM_RMW_ADD wraps around
+	Counter = 0xFFFFFFFE;
+	ret = Host.fetchAdd<uint32_t>(0, 3, &counter);
+	errors += check("fetchAdd", ret, counter, 0xFFFFFFFE, Counter, 1);
+
+	//MUCOM_RMW_CAS only stores the value if the compare value matches
+	ret = Host.compareAndSwap<uint32_t>(0, 1, 42, &counter);
+	errors += check("compareAndSwap", ret, counter, 1, Counter, 42);
+	ret = Host.compareAndSwap<uint32_t>(0, 1, 7, &counter);
+	errors += check("compareAndSwap", ret, counter, 42, Counter, 42);
+
+	//MUCOM_RMW_SET, MUCOM_RMW_CLEAR and MUCOM_RMW_TOGGLE
+	Flags = 0x00F0;
+	ret = Host.setBits<uint16_t>(1, 0x0104, &flags);
+	errors += check("setBits", ret, flags, 0x00F0, Flags, 0x01F4);
+	ret = Host.clearBits<uint16_t>(1, 0x00F0, &flags);
+	errors += check("clearBits", ret, flags, 0x01F4, Flags, 0x0104);
+	ret = Host.toggleBits<uint16_t>(1, 0x0101, &flags);
+	errors += check("toggleBits", ret, flags, 0x0104, Flags, 0x0005);
+
+	//MUCOM_RMW_MIN and MUCOM_RMW_MAX compare signed values for signed types
+	Level = -5;
+	ret = Host.fetchMin<int8_t>(2, -10, &level);
+	errors += check("fetchMin", ret, level, -5, Level, -10);
+	ret = Host.fetchMin<int8_t>(2, 3, &level);
+	errors += check("fetchMin", ret, level, -10, Level, -10);
+	ret = Host.fetchMax<int8_t>(2, -20, &level);
+	errors += check("fetchMax", ret, level, -10, Level, -10);
+	ret = Host.fetchMax<int8_t>(2, 3, &level);
+	errors += check("fetchMax", ret, level, -10, Level, 3);
+
+	Position = -1000;
+	ret = Host.fetchMax<int32_t>(3, 0, &position);
+	errors += check("fetchMax", ret, position, -1000, Position, 0);
+
+	//Invalid requests
+	start = now();
+	ret = Host.fetchAdd<uint32_t>(9, 1, &counter);
+	errors += checkRejected("unlinked index", ret, now() - start);
+
+	start = now();
+	ret = Host.fetchAdd<uint32_t>(1, 1, &counter);
+	errors += checkRejected("too large", ret, now() - start);
+
+	//The interface keeps working after rejected requests
+	ret = Host.fetchAdd<uint32_t>(0, 8, &counter);
+	errors += check("fetchAdd", ret, counter, 42, Counter, 50);
+
+	Running = 0;
+	pthread_join(thread, NULL);
+	close(fdDevice);
+	close(fdHost);
+
+	printf("%d errors\n", errors);
+	return (errors == 0) ? 0 : 1;
+}
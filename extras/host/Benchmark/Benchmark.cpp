@@ -0,0 +1,417 @@
+/*
+	Host benchmark: Measures the codec, the hot path of the interface and the round-trip latency over an in-process loopback link.
+	Both interfaces are compile-time configured and talk to each other via memory pipes, so no system calls are part of the measurement.
+	A pipe may simulate a serial line with a given baudrate (10 bits per byte).
+	The results are printed as one JSON object per line, e.g. to be collected and compared by a CI job.
+
+	Usage: muCom_benchmark [quick]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "muComStatic.h"
+
+
+#define PIPE_SIZE		65536	//Size of a memory pipe (power of 2)
+#define MAX_SAMPLES		20000	//Max. number of latency samples
+
+
+//One direction of the loopback link
+struct BenchPipe
+{
+	uint8_t data[PIPE_SIZE];
+	uint64_t ready[PIPE_SIZE];	//Time in ns the byte arrives at the receiver
+	uint32_t head, tail;
+	uint64_t line_free;			//Time in ns the simulated line is free again
+	uint32_t byte_ns;			//Time in ns to transmit a byte (0 = no delay)
+};
+
+
+//One side of the loopback link
+struct BenchEnd
+{
+	struct BenchPipe *tx, *rx;
+	void (*pump)(void *ctx);	//Handles the other side while waiting for data
+	void *ctx;
+	uint8_t pumping;
+};
+
+
+static uint64_t nowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+
+/*
+	Transport writing to and reading from memory pipes
+*/
+class BenchTransport
+{
+	private:
+		struct BenchEnd *_end;
+
+	public:
+		explicit BenchTransport(struct BenchEnd &end) : _end(&end)
+			{	}
+
+		void _write(uint8_t* data, uint8_t cnt)
+		{
+			struct BenchPipe *pipe = this->_end->tx;
+			uint64_t ready = nowNs();
+			uint8_t i;
+
+			if(pipe->byte_ns != 0)
+			{
+				if(pipe->line_free > ready)
+				{
+					ready = pipe->line_free;
+				}
+			}
+			for(i = 0; i < cnt; i++)
+			{
+				ready += pipe->byte_ns;
+				pipe->data[pipe->head & (PIPE_SIZE - 1)] = data[i];
+				pipe->ready[pipe->head & (PIPE_SIZE - 1)] = ready;
+				pipe->head++;
+			}
+			pipe->line_free = ready;
+		}
+
+		uint16_t _available(void)
+		{
+			struct BenchPipe *pipe = this->_end->rx;
+			uint64_t now;
+			uint32_t i;
+
+			if((pipe->head == pipe->tail) && (this->_end->pump != NULL) && (this->_end->pumping == 0))
+			{
+				//Let the other side answer
+				this->_end->pumping = 1;
+				this->_end->pump(this->_end->ctx);
+				this->_end->pumping = 0;
+			}
+
+			if(pipe->byte_ns == 0)
+			{
+				return (pipe->head - pipe->tail) > 0xFFFF ? 0xFFFF : (pipe->head - pipe->tail);
+			}
+
+			now = nowNs();
+			for(i = pipe->tail; (i != pipe->head) && (pipe->ready[i & (PIPE_SIZE - 1)] <= now) && ((i - pipe->tail) < 0xFFFF); i++);
+			return i - pipe->tail;
+		}
+
+		uint8_t _read(void)
+		{
+			struct BenchPipe *pipe = this->_end->rx;
+
+			return pipe->data[(pipe->tail++) & (PIPE_SIZE - 1)];
+		}
+
+		uint16_t _readBuffer(uint8_t *data, uint16_t max)
+		{
+			struct BenchPipe *pipe = this->_end->rx;
+			uint16_t cnt = this->_available();
+			uint16_t i;
+
+			if(cnt > max)
+			{
+				cnt = max;
+			}
+			for(i = 0; i < cnt; i++)
+			{
+				data[i] = pipe->data[(pipe->tail++) & (PIPE_SIZE - 1)];
+			}
+			return cnt;
+		}
+
+		uint8_t _availableTxBuffer(void)
+			{	return 255;	}
+
+		void _flushTx(void)
+			{	}
+
+		uint32_t _getTimestamp(void)
+			{	return (uint32_t)(nowNs() / 1000000);	}
+
+		uint32_t _getTimestampUs(void)
+			{	return (uint32_t)(nowNs() / 1000);	}
+
+		void _disableInterrupts(void)
+			{	}
+
+		void _enableInterrupts(void)
+			{	}
+};
+
+
+typedef muComStatic<BenchTransport, 8, 1> BenchInterface;
+
+
+static struct BenchPipe PipeA, PipeB;
+static struct BenchEnd EndDevice = {&PipeA, &PipeB, NULL, NULL, 0};
+static struct BenchEnd EndHost = {&PipeB, &PipeA, NULL, NULL, 0};
+static BenchInterface Device(EndDevice);
+static BenchInterface Host(EndHost);
+
+//Variables linked to the device side interface
+static uint8_t VarByte;
+static uint16_t VarShort;
+static uint32_t VarLong;
+static uint64_t VarLongLong;
+static float VarFloat;
+static double VarDouble;
+static volatile uint32_t Invoked;
+
+static uint32_t Samples[MAX_SAMPLES];
+static volatile uint32_t Sink;
+
+
+static void pumpDevice(void *ctx)
+{
+	((BenchInterface*)ctx)->handle();
+}
+
+
+static void doNothing(uint8_t *data, uint8_t cnt)
+{
+	(void)data;
+	(void)cnt;
+	Invoked++;
+}
+
+
+static void resetLink(uint32_t baud)
+{
+	PipeA.head = PipeA.tail = 0;
+	PipeB.head = PipeB.tail = 0;
+	PipeA.line_free = PipeB.line_free = 0;
+	PipeA.byte_ns = PipeB.byte_ns = (baud == 0) ? 0 : (uint32_t)(10000000000ull / baud);
+}
+
+
+static int compareSamples(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+
+	return (x > y) - (x < y);
+}
+
+
+//Encode and decode frames without any interface
+static void benchCodec(uint32_t n)
+{
+	uint8_t frame[MUCOM_MAX_FRAME_LEN];
+	uint8_t payload[MUCOM_MAX_PAYLOAD_LEN];
+	uint8_t data[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	uint64_t start;
+	uint32_t i;
+
+	start = nowNs();
+	for(i = 0; i < n; i++)
+	{
+		data[0] = (uint8_t)i;
+		Sink += muCom_encodeFrame(frame, MUCOM_WRITE_REQUEST, (uint8_t)i, data, 8);
+	}
+	printf("{\"bench\":\"codec_encode\",\"frames\":%u,\"ns_per_frame\":%.2f}\n", n, (double)(nowNs() - start) / n);
+
+	start = nowNs();
+	for(i = 0; i < n; i++)
+	{
+		frame[1] = i & 0x7F;
+		muCom_decodeFrame(frame, payload);
+		Sink += payload[1];
+	}
+	printf("{\"bench\":\"codec_decode\",\"frames\":%u,\"ns_per_frame\":%.2f}\n", n, (double)(nowNs() - start) / n);
+}
+
+
+//Cost of sending a frame (encode + write to the transport) and of handle() decoding and executing it
+static void benchHotPath(uint32_t n)
+{
+	uint64_t start, elapsed = 0;
+	uint32_t i, j, burst = PIPE_SIZE / MUCOM_MAX_FRAME_LEN / 2;
+
+	resetLink(0);
+	EndHost.pump = NULL;
+
+	for(i = 0; i < n; i += burst)
+	{
+		start = nowNs();
+		for(j = 0; j < burst; j++)
+		{
+			Host.writeLongLong(3, i + j);
+		}
+		elapsed += nowNs() - start;
+		PipeB.tail = PipeB.head; //Discard
+	}
+	printf("{\"bench\":\"write_encode\",\"frames\":%u,\"ns_per_frame\":%.2f}\n", i, (double)elapsed / i);
+
+	elapsed = 0;
+	for(i = 0; i < n; i += burst)
+	{
+		for(j = 0; j < burst; j++)
+		{
+			Host.writeLongLong(3, i + j);
+		}
+		start = nowNs();
+		Device.handle();
+		elapsed += nowNs() - start;
+	}
+	printf("{\"bench\":\"handle_decode\",\"frames\":%u,\"ns_per_frame\":%.2f}\n", i, (double)elapsed / i);
+}
+
+
+//Print the throughput of an API path. Each call transfers the given number of frames with "bytes" payload bytes (index + data) in total
+static void printThroughput(const char *name, uint32_t calls, uint8_t frames, uint8_t bytes, uint64_t elapsed)
+{
+	double seconds = (double)elapsed / 1e9;
+
+	printf("{\"bench\":\"%s\",\"calls\":%u,\"ns_per_call\":%.2f,\"frames_per_s\":%.0f,\"payload_bytes_per_s\":%.0f}\n",
+		name, calls, (double)elapsed / calls, calls * frames / seconds, calls * bytes / seconds);
+}
+
+
+#define BENCH_WRITE(name, call, size)												\
+	do																				\
+	{																				\
+		start = nowNs();															\
+		for(i = 0; i < n; i++)														\
+		{																			\
+			call;																	\
+			if((i & 1023) == 1023)													\
+			{																		\
+				Host.flush();														\
+				Device.handle();													\
+			}																		\
+		}																			\
+		Host.flush();																\
+		Device.handle();															\
+		printThroughput(name, n, 1, 1 + (size), nowNs() - start);					\
+	} while(0)
+
+#define BENCH_READ(name, call, size)												\
+	do																				\
+	{																				\
+		start = nowNs();															\
+		for(i = 0; i < n; i++)														\
+		{																			\
+			if((call) != MUCOM_OK)													\
+			{																		\
+				errors++;															\
+			}																		\
+		}																			\
+		printThroughput(name, n, 2, 2 + (size), nowNs() - start);					\
+	} while(0)
+
+
+//Throughput of all read and write functions over a link without delay
+static uint32_t benchThroughput(uint32_t n)
+{
+	uint8_t u8;
+	uint16_t u16;
+	uint32_t u32, i, errors = 0;
+	uint64_t u64, start;
+	float f32;
+	uint8_t param = 0;
+
+	resetLink(0);
+	EndHost.pump = pumpDevice;
+	EndHost.ctx = &Device;
+
+	BENCH_WRITE("writeByte", Host.writeByte(0, (uint8_t)i), 1);
+	BENCH_WRITE("writeShort", Host.writeShort(1, (uint16_t)i), 2);
+	BENCH_WRITE("writeLong", Host.writeLong(2, i), 4);
+	BENCH_WRITE("writeLongLong", Host.writeLongLong(3, i), 8);
+	BENCH_WRITE("writeFloat", Host.writeFloat(4, (float)i), 4);
+	BENCH_WRITE("writeDouble", Host.writeDouble(5, (double)i), 8);
+	BENCH_WRITE("invokeFunction", Host.invokeFunction(0, &param, 1), 1);
+
+#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+	//Frames collected and written to the HW at once
+	Host.setTxCoalescing(MUCOM_TX_BUFFER);
+	BENCH_WRITE("writeLong_coalesced", Host.writeLong(2, i), 4);
+	Host.setTxCoalescing(0);
+#endif
+
+	BENCH_READ("readByte", Host.readByte(0, &u8), 1);
+	BENCH_READ("readShort", Host.readShort(1, &u16), 2);
+	BENCH_READ("readLong", Host.readLong(2, &u32), 4);
+	BENCH_READ("readLongLong", Host.readLongLong(3, &u64), 8);
+	BENCH_READ("readFloat", Host.readFloat(4, &f32), 4);
+
+	if(Invoked < n)
+	{
+		errors++;
+	}
+
+	return errors;
+}
+
+
+//Round-trip time of readLong() over a simulated serial line
+static uint32_t benchLatency(uint32_t baud, uint32_t n)
+{
+	uint32_t i, value, errors = 0;
+	uint64_t start;
+
+	if(n > MAX_SAMPLES)
+	{
+		n = MAX_SAMPLES;
+	}
+
+	resetLink(baud);
+	EndHost.pump = pumpDevice;
+	EndHost.ctx = &Device;
+
+	for(i = 0; i < n; i++)
+	{
+		start = nowNs();
+		if(Host.readLong(2, &value) != MUCOM_OK)
+		{
+			errors++;
+		}
+		Samples[i] = (uint32_t)(nowNs() - start);
+	}
+
+	qsort(Samples, n, sizeof(Samples[0]), compareSamples);
+	printf("{\"bench\":\"read_latency\",\"baud\":%u,\"samples\":%u,\"p50_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f}\n",
+		baud, n, Samples[n / 2] / 1000.0, Samples[(n * 99) / 100] / 1000.0, Samples[n - 1] / 1000.0);
+
+	return errors;
+}
+
+
+int main(int argc, char **argv)
+{
+	static const uint32_t baudrates[] = {0, 4000000, 1000000, 250000, 115200};
+	uint32_t scale = ((argc > 1) && (strcmp(argv[1], "quick") == 0)) ? 10 : 1;
+	uint32_t i, errors = 0;
+
+	Device.linkVariable(0, &VarByte);
+	Device.linkVariable(1, &VarShort);
+	Device.linkVariable(2, &VarLong);
+	Device.linkVariable(3, &VarLongLong);
+	Device.linkVariable(4, &VarFloat);
+	Device.linkVariable(5, &VarDouble);
+	Device.linkFunction(0, doNothing);
+
+	benchCodec(10000000 / scale);
+	benchHotPath(2000000 / scale);
+	errors += benchThroughput(200000 / scale);
+	for(i = 0; i < sizeof(baudrates) / sizeof(baudrates[0]); i++)
+	{
+		//Approx. the same run time for all baudrates
+		errors += benchLatency(baudrates[i], (baudrates[i] == 0) ? 20000 / scale : baudrates[i] / 200 / scale);
+	}
+
+	printf("{\"bench\":\"errors\",\"count\":%u}\n", errors);
+
+	return (errors == 0) ? 0 : 1;
+}
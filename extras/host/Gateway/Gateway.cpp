@@ -0,0 +1,116 @@
+/*
+	Host example: One gateway driving many muCom links with a few worker threads.
+	Each simulated device is connected to its host link via a socketpair. Both sides of all pairs are handled by the gateway,
+	while the main thread only sends requests and collects the results via callbacks.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "muComGateway.h"
+#include "muComPosix.h"
+
+#define LINKS	64		//Number of simulated devices
+#define SHARDS	4		//Number of worker threads
+
+
+//Variables linked to the device side interfaces
+static uint32_t SerialNo[LINKS];
+
+static struct muCom_LinkedVariable_str DeviceVar[LINKS][1];
+static struct muCom_LinkedFunction_str DeviceFunc[LINKS][1];
+static struct muCom_LinkedVariable_str HostVar[LINKS][1];
+static struct muCom_LinkedFunction_str HostFunc[LINKS][1];
+
+static volatile int Answers = 0;
+static volatile int Errors = 0;
+
+
+void onRead(void *ctx, int16_t link, uint8_t index, int8_t status, uint8_t *data, uint8_t cnt)
+{
+	uint32_t value;
+	int device = (int)(intptr_t)ctx;
+
+	(void)link;
+	(void)index;
+
+	memcpy(&value, data, cnt);
+	if((status != MUCOM_OK) || (value != SerialNo[device]))
+	{
+		__atomic_add_fetch(&Errors, 1, __ATOMIC_RELAXED);
+	}
+	__atomic_add_fetch(&Answers, 1, __ATOMIC_RELEASE);
+}
+
+
+int main(void)
+{
+	muComPosix *device[LINKS];
+	muComPosix *host[LINKS];
+	int16_t hostLink[LINKS];
+	int fdDevice[LINKS], fdHost[LINKS];
+	muComGateway gateway(SHARDS);
+	uint32_t value;
+	int i, round;
+
+	for(i = 0; i < LINKS; i++)
+	{
+		if(muComPosix::openSocketPair(&fdDevice[i], &fdHost[i]) != MUCOM_OK)
+		{
+			perror("socketpair");
+			return 1;
+		}
+
+		SerialNo[i] = 1000 + i;
+		device[i] = new muComPosix(fdDevice[i], DeviceVar[i], 1, DeviceFunc[i], 1);
+		device[i]->linkVariable(0, &SerialNo[i]);
+		host[i] = new muComPosix(fdHost[i], HostVar[i], 1, HostFunc[i], 1);
+
+		//Keep device and host of a pair on different shards
+		gateway.addLink(device[i], fdDevice[i], i % SHARDS);
+		hostLink[i] = gateway.addLink(host[i], fdHost[i], (i + 1) % SHARDS);
+	}
+
+	gateway.start();
+
+	//Fire read requests to all devices at once and collect the results via the callback
+	for(round = 0; round < 10; round++)
+	{
+		Answers = 0;
+		for(i = 0; i < LINKS; i++)
+		{
+			if(gateway.readAsync(hostLink[i], 0, sizeof(uint32_t), onRead, (void*)(intptr_t)i) != MUCOM_OK)
+			{
+				Errors++;
+				Answers++;
+			}
+		}
+		while(__atomic_load_n(&Answers, __ATOMIC_ACQUIRE) < LINKS)
+		{
+			usleep(100);
+		}
+	}
+	printf("Async: %d reads, %d errors\n", 10 * LINKS, Errors);
+
+	//Blocking requests from the main thread
+	value = 4242;
+	gateway.write(hostLink[7], 0, (uint8_t*)&value, sizeof(value));
+	value = 0;
+	if((gateway.read(hostLink[7], 0, (uint8_t*)&value, sizeof(value)) != MUCOM_OK) || (value != 4242))
+	{
+		Errors++;
+	}
+	printf("Blocking: Device 7 = %u\n", value);
+
+	gateway.stop();
+
+	for(i = 0; i < LINKS; i++)
+	{
+		delete device[i];
+		delete host[i];
+		close(fdDevice[i]);
+		close(fdHost[i]);
+	}
+
+	return (Errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/*
+	Host test: Checksummed frames (see setCrc()) over a link corrupting bytes.
+	A relay thread between the host and the device flips single bits of a fixed share of the bytes in both directions.
+	The host writes variables above index 255 and elements of a linked buffer at a byte offset, i.e. frames preceded by
+	a MUCOM_EXT_PAGE or MUCOM_EXT_OFFSET prefix, and reads them back. The test fails if a corrupted or lost prefix ever makes
+	a frame access another variable or another part of the buffer, if a read returns a value never written or if the final
+	values differ from the last ones written. The corruption is pseudo-random with a fixed seed.
+	Beforehand a read of bytes outside the linked buffer has to be rejected with MUCOM_ERR over an undisturbed link, without
+	taking the response of the next read of the same index.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "muComPosix.h"
+
+
+#define ITERATIONS		1500
+#define GUARD_VALUE		0x5A5A5A5A
+#define GUARD_BYTE		0xA5
+
+//Variables linked to the device side interface
+uint32_t Low = GUARD_VALUE;			//Index 44, the lower byte of index 300
+uint32_t High = 0;					//Index 300
+uint8_t Table[64];					//Index 5, written at offset 40
+
+static volatile int Running = 1;
+
+typedef muComStatic<muComPosixTransport, 4, 0> DeviceInterface;
+
+
+//Relay between the host and the device
+struct Relay_str
+{
+	int fdHost;
+	int fdDevice;
+	uint32_t permille;		//Share of corrupted bytes in 1/1000
+	uint32_t random;		//State of the pseudo-random number generator
+	uint32_t corrupted;		//Number of corrupted bytes
+};
+
+
+static uint32_t nextRandom(struct Relay_str *relay)
+{
+	//xorshift32
+	relay->random ^= relay->random << 13;
+	relay->random ^= relay->random >> 17;
+	relay->random ^= relay->random << 5;
+	return relay->random;
+}
+
+
+static void forward(struct Relay_str *relay, int from, int to)
+{
+	uint8_t buf[256];
+	ssize_t cnt, i;
+
+	cnt = read(from, buf, sizeof(buf));
+	for(i = 0; i < cnt; i++)
+	{
+		if((nextRandom(relay) % 1000) < relay->permille)
+		{
+			buf[i] ^= 1 << (nextRandom(relay) % 8);
+			relay->corrupted++;
+		}
+	}
+	if(cnt > 0)
+	{
+		(void)!write(to, buf, cnt);
+	}
+}
+
+
+void *relayThread(void *arg)
+{
+	struct Relay_str *relay = (struct Relay_str*)arg;
+	struct pollfd pfd[2];
+
+	pfd[0].fd = relay->fdHost;
+	pfd[0].events = POLLIN;
+	pfd[1].fd = relay->fdDevice;
+	pfd[1].events = POLLIN;
+
+	while(Running)
+	{
+		if(poll(pfd, 2, 10) <= 0)
+		{
+			continue;
+		}
+		if(pfd[0].revents & POLLIN)
+		{
+			forward(relay, relay->fdHost, relay->fdDevice);
+		}
+		if(pfd[1].revents & POLLIN)
+		{
+			forward(relay, relay->fdDevice, relay->fdHost);
+		}
+	}
+	return NULL;
+}
+
+
+void *deviceThread(void *arg)
+{
+	DeviceInterface *device = (DeviceInterface*)arg;
+
+	while(Running)
+	{
+		device->handle();
+		usleep(50);
+	}
+	return NULL;
+}
+
+
+//Check that nothing but the written variable and bytes changed
+static int checkGuards(void)
+{
+	int i;
+
+	if(Low != GUARD_VALUE)
+	{
+		printf("Index 44 was overwritten with 0x%08X!\n", (unsigned int)Low);
+		return 1;
+	}
+	for(i = 0; i < (int)sizeof(Table); i++)
+	{
+		if(((i < 40) || (i >= 44)) && (Table[i] != GUARD_BYTE))
+		{
+			printf("Table[%d] was overwritten with 0x%02X!\n", i, Table[i]);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+
+//A rejected read must not take the response of the next read of the index
+static int checkOutOfRange(void)
+{
+	int fdHost, fdDevice;
+	pthread_t thread;
+	uint8_t outside[4] = {0, 0, 0, 0}, inside[4] = {0, 0, 0, 0};
+	int8_t tagOutside, tagInside, retOutside, retInside;
+	int errors = 0, i;
+
+	if(muComPosix::openSocketPair(&fdHost, &fdDevice) != MUCOM_OK)
+	{
+		perror("socketpair");
+		return 1;
+	}
+
+	for(i = 0; i < (int)sizeof(Table); i++)
+	{
+		Table[i] = i;
+	}
+
+	DeviceInterface Device(fdDevice);
+	MUCOM_POSIX_CREATE(Host, fdHost, 0, 0);
+
+	Device.linkVariable(5, Table, sizeof(Table));
+	Host.setTimeout(1000);
+
+	Running = 1;
+	pthread_create(&thread, NULL, deviceThread, &Device);
+
+	tagOutside = Host.readAtAsync(5, 100, outside, sizeof(outside));
+	tagInside = Host.readAtAsync(5, 40, inside, sizeof(inside));
+	Host.flush();
+	while((retOutside = Host.readStatus(tagOutside)) == MUCOM_PENDING)
+	{
+		Host.handle();
+	}
+	while((retInside = Host.readStatus(tagInside)) == MUCOM_PENDING)
+	{
+		Host.handle();
+	}
+
+	if((retOutside != MUCOM_ERR) || (outside[0] != 0))
+	{
+		printf("Read outside the buffer returned %d instead of being rejected!\n", retOutside);
+		errors++;
+	}
+	if((retInside != MUCOM_OK) || (inside[0] != 40) || (inside[3] != 43))
+	{
+		printf("Read at offset 40 returned %d, first byte %u!\n", retInside, inside[0]);
+		errors++;
+	}
+
+	Running = 0;
+	pthread_join(thread, NULL);
+	close(fdHost);
+	close(fdDevice);
+
+	printf("Out-of-range read: %d errors\n", errors);
+	return errors;
+}
+
+
+static int run(uint32_t permille)
+{
+	int fdHost, fdHostRelay, fdDevice, fdDeviceRelay;
+	struct Relay_str relay;
+	pthread_t threads[2];
+	uint32_t value, written, lastOk = 0;
+	uint8_t element[4];
+	int errors = 0, i, j;
+	int8_t ret;
+
+	if((muComPosix::openSocketPair(&fdHost, &fdHostRelay) != MUCOM_OK) || (muComPosix::openSocketPair(&fdDevice, &fdDeviceRelay) != MUCOM_OK))
+	{
+		perror("socketpair");
+		return 1;
+	}
+
+	Low = GUARD_VALUE;
+	High = 0;
+	memset(Table, GUARD_BYTE, sizeof(Table));
+
+	DeviceInterface Device(fdDevice);
+	MUCOM_POSIX_CREATE(Host, fdHost, 0, 0);
+
+	Device.linkVariable(44, &Low);
+	Device.linkVariable(300, &High);
+	Device.linkVariable(5, Table, sizeof(Table));
+	Device.setCrc(1);
+	Host.setCrc(1);
+	Host.setTimeout(20);
+
+	relay.fdHost = fdHostRelay;
+	relay.fdDevice = fdDeviceRelay;
+	relay.permille = permille;
+	relay.random = 0x12345678 + permille;
+	relay.corrupted = 0;
+
+	Running = 1;
+	pthread_create(&threads[0], NULL, relayThread, &relay);
+	pthread_create(&threads[1], NULL, deviceThread, &Device);
+
+	for(i = 1; (i <= ITERATIONS) && (errors == 0); i++)
+	{
+		written = 1000 + i;
+		memcpy(element, &written, sizeof(element));
+		Host.writeLong(300, written);
+		Host.writeAt(5, 40, element, sizeof(element));
+
+		//A write may get lost, but a read never returns a value which was not written
+		ret = Host.readLong(300, &value);
+		if((ret == MUCOM_OK) && ((value < lastOk) || (value > written)))
+		{
+			printf("Read %u after writing %u!\n", (unsigned int)value, (unsigned int)written);
+			errors++;
+		}
+		if(ret == MUCOM_OK)
+		{
+			lastOk = value;
+		}
+		errors += checkGuards();
+	}
+
+	//The last values have to arrive eventually
+	for(j = 0; (j < 100) && (errors == 0); j++)
+	{
+		Host.writeLong(300, written);
+		Host.writeAt(5, 40, element, sizeof(element));
+		if((Host.readLong(300, &value) == MUCOM_OK) && (value == written) && (Host.readAt(5, 40, (uint8_t*)&value, 4) == MUCOM_OK) && (value == written))
+		{
+			break;
+		}
+	}
+	if((errors == 0) && ((High != written) || (memcmp(&Table[40], element, sizeof(element)) != 0)))
+	{
+		printf("Final values differ: %u at index 300!\n", (unsigned int)High);
+		errors++;
+	}
+	if(errors == 0)
+	{
+		errors += checkGuards();
+	}
+
+	Running = 0;
+	pthread_join(threads[0], NULL);
+	pthread_join(threads[1], NULL);
+	close(fdHost);
+	close(fdHostRelay);
+	close(fdDevice);
+	close(fdDeviceRelay);
+
+	printf("%u.%u%% corrupted bytes: %u bytes corrupted, %d errors\n", (unsigned int)(permille / 10), (unsigned int)(permille % 10),
+		(unsigned int)relay.corrupted, errors);
+	return errors;
+}
+
+
+int main(void)
+{
+	int errors = 0;
+
+	errors += checkOutOfRange();
+	errors += run(10);
+	errors += run(30);
+
+	return (errors == 0) ? 0 : 1;
+}
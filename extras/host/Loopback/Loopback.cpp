@@ -0,0 +1,135 @@
+/*
+	Host example: Two muCom interfaces talking to each other via an in-process socketpair.
+	The "device" side is handled by its own thread while the main thread acts as the communication partner.
+	The device uses the compile-time configured interface (no virtual dispatch) with constant link tables, the host the classic muComPosix class.
+*/
+
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "muComPosix.h"
+
+
+//Variables linked to the device side interface
+int32_t Counter = 0;
+float Voltage = 3.3;
+
+static volatile int Running = 1;
+
+//Device interface without buffers, everything is linked via constant tables
+typedef muComStatic<muComPosixTransport, 0, 0> DeviceInterface;
+
+
+void setCounter(uint8_t *data, uint8_t cnt)
+{
+	if(cnt == 1)
+	{
+		Counter = data[0];
+	}
+}
+
+
+//Constant link tables of the device (located in flash on AVR)
+static constexpr struct muCom_LinkedVariable_str DeviceVars[] MUCOM_PROGMEM = {
+	MUCOM_VAR(0, Counter),
+	MUCOM_VAR(1, Voltage),
+};
+static constexpr struct muCom_LinkedFunction_str DeviceFuncs[] MUCOM_PROGMEM = {
+	MUCOM_FUNC(0, setCounter),
+};
+MUCOM_CHECK_TABLE(DeviceVars);
+MUCOM_CHECK_TABLE(DeviceFuncs);
+
+
+void *deviceThread(void *arg)
+{
+	DeviceInterface *device = (DeviceInterface*)arg;
+
+	while(Running)
+	{
+		device->handle();
+		usleep(100);
+	}
+	return NULL;
+}
+
+
+int main(void)
+{
+	int fdDevice, fdHost;
+	pthread_t thread;
+	int32_t counter;
+	float voltage;
+	int i;
+
+	if(muComPosix::openSocketPair(&fdDevice, &fdHost) != MUCOM_OK)
+	{
+		perror("socketpair");
+		return 1;
+	}
+
+	DeviceInterface Device(fdDevice);
+	MUCOM_POSIX_CREATE(Host, fdHost, 0, 0);
+
+	Device.linkTable(DeviceVars, DeviceFuncs);
+
+	pthread_create(&thread, NULL, deviceThread, &Device);
+
+	Host.invokeFunction(0, (uint8_t*)"\x10", 1);
+	for(i = 0; i < 10; i++)
+	{
+		Host.writeFloat(1, 1.5 * i);
+		if((Host.readLong(0, &counter) != MUCOM_OK) || (Host.readFloat(1, &voltage) != MUCOM_OK))
+		{
+			printf("Read failed!\n");
+			break;
+		}
+		printf("Counter = %d, Voltage = %.2f\n", (int)counter, voltage);
+		Host.writeLong(0, counter + 1);
+	}
+
+	//Pipelined reads: Send all requests at once and collect the responses afterwards
+	if(i == 10)
+	{
+		int8_t tagCounter = Host.readAsync(0, (uint8_t*)&counter, sizeof(counter));
+		int8_t tagVoltage = Host.readAsync(1, (uint8_t*)&voltage, sizeof(voltage));
+		int8_t statusCounter, statusVoltage;
+
+		while((statusCounter = Host.readStatus(tagCounter)) == MUCOM_PENDING)
+		{
+			Host.handle();
+		}
+		while((statusVoltage = Host.readStatus(tagVoltage)) == MUCOM_PENDING)
+		{
+			Host.handle();
+		}
+		if((statusCounter != MUCOM_OK) || (statusVoltage != MUCOM_OK))
+		{
+			printf("Pipelined read failed!\n");
+			i = 0;
+		}
+		printf("Pipelined: Counter = %d, Voltage = %.2f\n", (int)counter, voltage);
+	}
+
+	//Batch read: Both variables are copied by the device at the same time
+	if(i == 10)
+	{
+		const uint8_t index[2] = {0, 1};
+		uint8_t * const data[2] = {(uint8_t*)&counter, (uint8_t*)&voltage};
+		const uint8_t cnt[2] = {sizeof(counter), sizeof(voltage)};
+
+		if(Host.readBatch(index, data, cnt, 2) != MUCOM_OK)
+		{
+			printf("Batch read failed!\n");
+			i = 0;
+		}
+		printf("Batch: Counter = %d, Voltage = %.2f\n", (int)counter, voltage);
+	}
+
+	Running = 0;
+	pthread_join(thread, NULL);
+	close(fdDevice);
+	close(fdHost);
+
+	return (i == 10) ? 0 : 1;
+}
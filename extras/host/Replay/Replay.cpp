@@ -0,0 +1,299 @@
+/*
+	Host example: Capture the traffic of a device into a trace file and replay it offline.
+	"record" runs a short session between a host and a device linked via a socketpair and writes the data exchanged by the device into a trace.
+	"replay" feeds the received bytes of the trace back through handle() of a device linked the same way, either at full speed
+	or at the original timing, and checks that the device answers exactly like while recording.
+	"dump" lists all records of a trace. Without arguments a temporary trace is recorded and replayed at full speed.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "muComPosix.h"
+#include "muComTrace.h"
+
+
+//Variables linked to the device side interface
+int32_t Counter = 0;
+float Voltage = 3.3;
+
+static volatile int Running = 1;
+
+//Device interface while recording and while replaying
+typedef muComStatic<muComPosixTransport, 0, 0> DeviceInterface;
+typedef muComStatic<muComReplayTransport, 0, 0> ReplayInterface;
+
+
+void setCounter(uint8_t *data, uint8_t cnt)
+{
+	if(cnt == 1)
+	{
+		Counter = data[0];
+	}
+}
+
+
+//Constant link tables shared by both device interfaces
+static constexpr struct muCom_LinkedVariable_str DeviceVars[] MUCOM_PROGMEM = {
+	MUCOM_VAR(0, Counter),
+	MUCOM_VAR(1, Voltage),
+};
+static constexpr struct muCom_LinkedFunction_str DeviceFuncs[] MUCOM_PROGMEM = {
+	MUCOM_FUNC(0, setCounter),
+};
+MUCOM_CHECK_TABLE(DeviceVars);
+MUCOM_CHECK_TABLE(DeviceFuncs);
+
+
+void *deviceThread(void *arg)
+{
+	DeviceInterface *device = (DeviceInterface*)arg;
+
+	while(Running)
+	{
+		device->handle();
+		usleep(100);
+	}
+	return NULL;
+}
+
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static const char *typeName(uint8_t type)
+{
+	switch(type)
+	{
+		case MUCOM_CAPTURE_RX:			return "RX      ";
+		case MUCOM_CAPTURE_TX:			return "TX      ";
+		case MUCOM_CAPTURE_FRAME_RX:	return "FRAME RX";
+		case MUCOM_CAPTURE_FRAME_TX:	return "FRAME TX";
+		default:						return "USER    ";
+	}
+}
+
+
+static const char *frameName(uint8_t header)
+{
+	switch(header & MUCOM_FRAME_DESC_MASK)
+	{
+		case MUCOM_READ_RESPONSE:	return "read response";
+		case MUCOM_READ_REQUEST:	return "read request";
+		case MUCOM_WRITE_REQUEST:	return "write request";
+		default:					return "execute request";
+	}
+}
+
+
+//Run a short session with the device and record the data exchanged by it
+static int record(const char *path)
+{
+	int fdDevice, fdHost;
+	pthread_t thread;
+	muComTrace trace;
+	int32_t counter;
+	float voltage;
+	int i;
+
+	if(muComPosix::openSocketPair(&fdDevice, &fdHost) != MUCOM_OK)
+	{
+		perror("socketpair");
+		return 1;
+	}
+	if(trace.open(path) != MUCOM_OK)
+	{
+		perror(path);
+		return 1;
+	}
+
+	DeviceInterface Device(fdDevice);
+	MUCOM_POSIX_CREATE(Host, fdHost, 0, 0);
+
+	Device.linkTable(DeviceVars, DeviceFuncs);
+	Device.setCapture(muComTrace::capture, &trace);
+
+	Running = 1;
+	pthread_create(&thread, NULL, deviceThread, &Device);
+
+	for(i = 0; i < 200; i++)
+	{
+		if((i % 50) == 0)
+		{
+			Host.invokeFunction(0, (uint8_t*)"\x10", 1);
+		}
+		Host.writeFloat(1, 0.5 * i);
+		if((Host.readLong(0, &counter) != MUCOM_OK) || (Host.readFloat(1, &voltage) != MUCOM_OK))
+		{
+			printf("Read failed!\n");
+			break;
+		}
+		Host.writeLong(0, counter + 1);
+	}
+	Host.readLong(0, &counter);
+
+	Running = 0;
+	pthread_join(thread, NULL);
+	Device.setCapture(NULL, NULL);
+	close(fdDevice);
+	close(fdHost);
+
+	if(trace.close() != MUCOM_OK)
+	{
+		printf("Writing %s failed!\n", path);
+		return 1;
+	}
+	printf("Recorded %s: Counter = %d, Voltage = %.2f\n", path, (int)Counter, Voltage);
+	return (i == 200) ? 0 : 1;
+}
+
+
+
+//Feed the trace through a device linked like the recording one
+static int replay(const char *path, uint8_t realtime)
+{
+	const struct muCom_TraceRecord_str *record;
+	muComTraceReader reader;
+	uint32_t frames = 0;
+	double start, duration;
+
+	if(reader.open(path) != MUCOM_OK)
+	{
+		printf("%s is no valid trace!\n", path);
+		return 1;
+	}
+	for(record = reader.first(); record != NULL; record = reader.next(record))
+	{
+		if(record->type == MUCOM_CAPTURE_FRAME_RX)
+		{
+			frames++;
+		}
+	}
+
+	ReplayInterface Device(reader);
+
+	Device.linkTable(DeviceVars, DeviceFuncs);
+	Device.setRealtime(realtime);
+
+	start = now();
+	while(!Device.done())
+	{
+		Device.handle();
+		if(realtime)
+		{
+			usleep(100);
+		}
+	}
+	duration = now() - start;
+
+	printf("Replayed %u frames in %.3f ms (%.0f frames/s): Counter = %d, Voltage = %.2f, %u bytes differ\n",
+		(unsigned int)frames, duration * 1e3, frames / duration, (int)Counter, Voltage, (unsigned int)Device.getMismatches());
+	return (Device.getMismatches() == 0) ? 0 : 1;
+}
+
+
+
+//List all records of a trace
+static int dump(const char *path)
+{
+	const struct muCom_TraceRecord_str *record;
+	muComTraceReader reader;
+	const uint8_t *data;
+	uint64_t time = 0;
+	uint16_t i;
+
+	if(reader.open(path) != MUCOM_OK)
+	{
+		printf("%s is no valid trace!\n", path);
+		return 1;
+	}
+
+	for(record = reader.first(); record != NULL; record = reader.next(record))
+	{
+		time += record->delay;
+		data = muComTraceReader::getData(record);
+
+		printf("%10.3f ms  %s ", time * 1e-3, typeName(record->type));
+		if(((record->type == MUCOM_CAPTURE_FRAME_RX) || (record->type == MUCOM_CAPTURE_FRAME_TX)) && (record->cnt >= 2))
+		{
+			printf(" %-15s index %3u:", frameName(data[0]), data[1]);
+			for(i = 2; i < record->cnt; i++)
+			{
+				printf(" %02X", data[i]);
+			}
+		}
+		else
+		{
+			for(i = 0; i < record->cnt; i++)
+			{
+				printf(" %02X", data[i]);
+			}
+		}
+		printf("\n");
+	}
+	return 0;
+}
+
+
+
+int main(int argc, char **argv)
+{
+	char path[] = "/tmp/muCom_traceXXXXXX";
+	int32_t counter;
+	float voltage;
+	int fd, ret;
+
+	if((argc == 3) && (strcmp(argv[1], "record") == 0))
+	{
+		return record(argv[2]);
+	}
+	if(((argc == 3) || (argc == 4)) && (strcmp(argv[1], "replay") == 0))
+	{
+		return replay(argv[2], ((argc == 4) && (strcmp(argv[3], "realtime") == 0)) ? 1 : 0);
+	}
+	if((argc == 3) && (strcmp(argv[1], "dump") == 0))
+	{
+		return dump(argv[2]);
+	}
+	if(argc != 1)
+	{
+		fprintf(stderr, "Usage: %s [record <trace> | replay <trace> [realtime] | dump <trace>]\n", argv[0]);
+		return 1;
+	}
+
+	//Self check: The replay has to end with the same values as the recording
+	fd = mkstemp(path);
+	if(fd < 0)
+	{
+		perror("mkstemp");
+		return 1;
+	}
+	close(fd);
+
+	ret = record(path);
+	counter = Counter;
+	voltage = Voltage;
+	Counter = 0;
+	Voltage = 3.3;
+	if(ret == 0)
+	{
+		ret = replay(path, 0);
+	}
+	if((ret == 0) && ((Counter != counter) || (Voltage != voltage)))
+	{
+		printf("Replay ended with different values!\n");
+		ret = 1;
+	}
+	unlink(path);
+
+	return ret;
+}
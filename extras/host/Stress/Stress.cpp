@@ -0,0 +1,293 @@
+/*
+	Host example: Hundreds of muCom links running concurrently.
+	Every thread owns a group of device/host pairs connected via memory pipes and handles all of them in an interleaved order.
+	The pipes hand out the received bytes in small pieces, so frames of all links are split across many calls of handle().
+	As every interface keeps its parser state in the object, no link disturbs another one and no locks are shared between the threads.
+
+	Usage: muCom_stress [pairs] [threads]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "muComStatic.h"
+
+
+#define PIPE_SIZE		1024	//Size of a memory pipe (power of 2)
+#define ROUNDS			200		//Number of write/read rounds per pair
+#define READS			3		//Number of pipelined read requests per pair and round
+
+
+//One direction of a link
+struct StressPipe
+{
+	uint8_t data[PIPE_SIZE];
+	uint32_t head, tail;
+	uint8_t piece;				//Size of the last piece handed to the receiver
+};
+
+
+//One side of a link
+struct StressEnd
+{
+	struct StressPipe *tx, *rx;
+};
+
+
+/*
+	Transport writing to and reading from memory pipes in pieces of 1 to 5 bytes
+*/
+class StressTransport
+{
+	private:
+		struct StressPipe *_tx, *_rx;
+
+	public:
+		explicit StressTransport(struct StressEnd &end) : _tx(end.tx), _rx(end.rx)
+			{	}
+
+		void _write(uint8_t* data, uint8_t cnt)
+		{
+			uint8_t i;
+
+			for(i = 0; i < cnt; i++)
+			{
+				this->_tx->data[(this->_tx->head++) & (PIPE_SIZE - 1)] = data[i];
+			}
+		}
+
+		uint16_t _available(void)
+			{	return this->_rx->head - this->_rx->tail;	}
+
+		uint8_t _read(void)
+			{	return this->_rx->data[(this->_rx->tail++) & (PIPE_SIZE - 1)];	}
+
+		uint16_t _readBuffer(uint8_t *data, uint16_t max)
+		{
+			uint16_t cnt = this->_available();
+			uint16_t i;
+
+			//Hand out a single piece per call, so handle() returns in the middle of a frame
+			this->_rx->piece = (this->_rx->piece % 5) + 1;
+			if(cnt > this->_rx->piece)
+			{
+				cnt = this->_rx->piece;
+			}
+			if(cnt > max)
+			{
+				cnt = max;
+			}
+			for(i = 0; i < cnt; i++)
+			{
+				data[i] = this->_read();
+			}
+			return cnt;
+		}
+
+		uint8_t _availableTxBuffer(void)
+			{	return 255;	}
+
+		void _flushTx(void)
+			{	}
+
+		uint32_t _getTimestamp(void)
+		{
+			struct timespec ts;
+
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (uint32_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+		}
+
+		uint32_t _getTimestampUs(void)
+		{
+			struct timespec ts;
+
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+		}
+
+		void _disableInterrupts(void)
+			{	}
+
+		void _enableInterrupts(void)
+			{	}
+};
+
+
+typedef muComStatic<StressTransport, 1, 1> StressInterface;
+
+
+//One device/host pair
+struct StressPair
+{
+	struct StressPipe to_device, to_host;
+	struct StressEnd device_end, host_end;
+	StressInterface *device;
+	StressInterface *host;
+	uint32_t value;					//Variable linked to the device
+	uint32_t result[READS];			//Values read by the host
+	int8_t tag[READS];
+};
+
+
+//Work of one thread
+struct StressGroup
+{
+	pthread_t thread;
+	struct StressPair *pairs;
+	int num;
+	uint32_t id;
+	long errors;
+	long reads;
+};
+
+
+static void *stressThread(void *arg)
+{
+	struct StressGroup *group = (struct StressGroup*)arg;
+	struct StressPair *pair;
+	uint32_t expected;
+	int round, i, j, pending;
+	int8_t status;
+
+	for(round = 0; round < ROUNDS; round++)
+	{
+		//Write a new value to all devices of the group and request it several times
+		for(i = 0; i < group->num; i++)
+		{
+			pair = &group->pairs[i];
+			expected = (group->id << 24) | ((uint32_t)i << 12) | (uint32_t)round;
+			pair->host->write(0, (uint8_t*)&expected, sizeof(expected));
+			for(j = 0; j < READS; j++)
+			{
+				pair->result[j] = 0;
+				pair->tag[j] = pair->host->readAsync(0, (uint8_t*)&pair->result[j], sizeof(uint32_t));
+				if(pair->tag[j] < 0)
+				{
+					group->errors++;
+				}
+			}
+		}
+
+		//Handle all links of the group in turns until every request is answered
+		do
+		{
+			pending = 0;
+			for(i = 0; i < group->num; i++)
+			{
+				pair = &group->pairs[i];
+				pair->device->handle();
+				pair->host->handle();
+				for(j = 0; j < READS; j++)
+				{
+					if(pair->tag[j] < 0)
+					{
+						continue;
+					}
+					status = pair->host->readStatus(pair->tag[j]);
+					if(status == MUCOM_PENDING)
+					{
+						pending++;
+						continue;
+					}
+
+					expected = (group->id << 24) | ((uint32_t)i << 12) | (uint32_t)round;
+					if((status != MUCOM_OK) || (pair->result[j] != expected) || (pair->value != expected))
+					{
+						group->errors++;
+					}
+					group->reads++;
+					pair->tag[j] = -1;
+				}
+			}
+		} while(pending != 0);
+	}
+
+	return NULL;
+}
+
+
+int main(int argc, char **argv)
+{
+	struct StressGroup *groups;
+	struct StressPair *pairs;
+	int num_pairs = 512;
+	int num_threads = 8;
+	long errors = 0, reads = 0;
+	struct timespec start, stop;
+	int i, per_thread;
+
+	if(argc > 1)
+	{
+		num_pairs = atoi(argv[1]);
+	}
+	if(argc > 2)
+	{
+		num_threads = atoi(argv[2]);
+	}
+	if((num_pairs < 1) || (num_threads < 1) || (num_threads > num_pairs) || (num_threads > 255) || (num_pairs >= 4096))
+	{
+		fprintf(stderr, "Usage: %s [pairs (1..4095)] [threads (1..255)]\n", argv[0]);
+		return 1;
+	}
+
+	pairs = new struct StressPair[num_pairs];
+	for(i = 0; i < num_pairs; i++)
+	{
+		memset(&pairs[i].to_device, 0, sizeof(struct StressPipe));
+		memset(&pairs[i].to_host, 0, sizeof(struct StressPipe));
+		pairs[i].device_end.tx = &pairs[i].to_host;
+		pairs[i].device_end.rx = &pairs[i].to_device;
+		pairs[i].host_end.tx = &pairs[i].to_device;
+		pairs[i].host_end.rx = &pairs[i].to_host;
+
+		pairs[i].value = 0;
+		pairs[i].device = new StressInterface(pairs[i].device_end);
+		pairs[i].device->linkVariable(0, &pairs[i].value);
+		pairs[i].host = new StressInterface(pairs[i].host_end);
+	}
+
+	//Distribute the pairs to the threads
+	groups = new struct StressGroup[num_threads];
+	per_thread = num_pairs / num_threads;
+	for(i = 0; i < num_threads; i++)
+	{
+		groups[i].pairs = &pairs[i * per_thread];
+		groups[i].num = (i == (num_threads - 1)) ? (num_pairs - i * per_thread) : per_thread;
+		groups[i].id = i;
+		groups[i].errors = 0;
+		groups[i].reads = 0;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(i = 0; i < num_threads; i++)
+	{
+		if(pthread_create(&groups[i].thread, NULL, stressThread, &groups[i]) != 0)
+		{
+			perror("pthread_create");
+			return 1;
+		}
+	}
+	for(i = 0; i < num_threads; i++)
+	{
+		pthread_join(groups[i].thread, NULL);
+		errors += groups[i].errors;
+		reads += groups[i].reads;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &stop);
+
+	printf("Stress: %d links, %d threads, %ld reads, %ld errors, %.1f ms\n", num_pairs, num_threads, reads, errors,
+		(stop.tv_sec - start.tv_sec) * 1e3 + (stop.tv_nsec - start.tv_nsec) / 1e6);
+
+	for(i = 0; i < num_pairs; i++)
+	{
+		delete pairs[i].device;
+		delete pairs[i].host;
+	}
+	delete[] pairs;
+	delete[] groups;
+
+	return ((errors == 0) && (reads == (long)num_pairs * ROUNDS * READS)) ? 0 : 1;
+}
@@ -10,20 +10,21 @@
 
 #include <Arduino.h>
 #include "muComBase.h"
+#include "muComStatic.h"
 
 #define MUCOM_CREATE(name, serial, num_var, num_func)							\
 	struct muCom_LinkedVariable_str _##name##_var_buf[ num_var ];				\
-	muComFunc _##name##_func_buf[ num_func ];									\
+	struct muCom_LinkedFunction_str _##name##_func_buf[ num_func ];			\
 	muCom name(serial, _##name##_var_buf, num_var, _##name##_func_buf, num_func);
 
 
 /**
-	\brief		Main class for the muCom interface when being used for an Arduino
-	\details	This class inherits all functions from the muCom base class (see muComBase)
-				and additionally implements the interface for the HW access when using the muCom interface on an Arduino.
+	\brief		Transport for the muCom interface when being used for an Arduino
+	\details	Implements the HW access when using the muCom interface on an Arduino.
 				It uses the Stream class for communication which can be implemented by the hardware and software UARTS, as well as USB serial emulations.
+				Used by muCom and as transport of muComStatic, e.g. muComStatic<muComSerialTransport, 8, 4> link(Serial);
 */
-class muCom : public muComBase
+class muComSerialTransport
 {
 	private:
 		#ifdef __AVR__
@@ -32,14 +33,34 @@ class muCom : public muComBase
 			UARTClass *_ser;
 		#endif
 		
+	public:
+		#ifdef __AVR__
+			explicit muComSerialTransport(Stream &ser)
+				{	this->_ser = &ser;	}
+		#else
+			explicit muComSerialTransport(UARTClass &ser)
+				{	this->_ser = &ser;	}
+		#endif
+		
+		//HW functions used by muComCore
 		inline void _write(uint8_t* data, uint8_t cnt)
 			{	this->_ser->write(data, cnt);	}
 		
 		inline uint8_t _read(void)
 			{	return this->_ser->read();	}
 		
-		inline uint8_t _available(void)
+		inline uint16_t _available(void)
 			{	return this->_ser->available();	}
+		
+		inline uint16_t _readBuffer(uint8_t *data, uint16_t max)
+			{
+				int cnt = this->_ser->available();
+				if(cnt > (int)max)
+				{
+					cnt = max;
+				}
+				return (cnt > 0) ? this->_ser->readBytes(data, cnt) : 0;
+			}
 			
 		inline uint8_t _availableTxBuffer(void)
 			{	return this->_ser->availableForWrite();	}
@@ -50,20 +71,65 @@ class muCom : public muComBase
 		inline uint32_t _getTimestamp(void)
 			{	return millis();	}
 		
+		inline uint32_t _getTimestampUs(void)
+			{	return micros();	}
+		
 		inline void _disableInterrupts(void)
 			{	noInterrupts();	}
 		
 		inline void _enableInterrupts(void)
 			{	interrupts();	}
+};
+
+
+/**
+	\brief		Main class for the muCom interface when being used for an Arduino
+	\details	This class inherits all functions from the muCom base class (see muComBase)
+				and additionally implements the interface for the HW access when using the muCom interface on an Arduino (see muComSerialTransport).
+*/
+class muCom : public muComBase
+{
+	private:
+		muComSerialTransport _transport;	//Actual HW access
+		
+		inline void _write(uint8_t* data, uint8_t cnt)
+			{	this->_transport._write(data, cnt);	}
+		
+		inline uint8_t _read(void)
+			{	return this->_transport._read();	}
+		
+		inline uint8_t _available(void)
+			{	uint16_t cnt = this->_transport._available(); return (cnt > 0xFF) ? 0xFF : (uint8_t)cnt;	}
+		
+		inline uint16_t _readBuffer(uint8_t *data, uint16_t max)
+			{	return this->_transport._readBuffer(data, max);	}
+			
+		inline uint8_t _availableTxBuffer(void)
+			{	return this->_transport._availableTxBuffer();	}
+		
+		inline void _flushTx(void)
+			{	this->_transport._flushTx();	}
+		
+		inline uint32_t _getTimestamp(void)
+			{	return this->_transport._getTimestamp();	}
+		
+		inline uint32_t _getTimestampUs(void)
+			{	return this->_transport._getTimestampUs();	}
+		
+		inline void _disableInterrupts(void)
+			{	this->_transport._disableInterrupts();	}
+		
+		inline void _enableInterrupts(void)
+			{	this->_transport._enableInterrupts();	}
 		
 	public:
 		
 		#ifdef __AVR__
-			muCom(Stream &ser, struct muCom_LinkedVariable_str *var_buf, uint8_t num_var, muComFunc *func_buf, uint8_t num_func) : muComBase(var_buf, num_var, func_buf, num_func)
-				{	this->_ser = &ser;	}
+			muCom(Stream &ser, struct muCom_LinkedVariable_str *var_buf, uint16_t num_var, struct muCom_LinkedFunction_str *func_buf, uint16_t num_func) : muComBase(var_buf, num_var, func_buf, num_func), _transport(ser)
+				{	}
 		#else
-			muCom(UARTClass &ser, struct muCom_LinkedVariable_str *var_buf, uint8_t num_var, muComFunc *func_buf, uint8_t num_func) : muComBase(var_buf, num_var, func_buf, num_func)
-				{	this->_ser = &ser;	}
+			muCom(UARTClass &ser, struct muCom_LinkedVariable_str *var_buf, uint16_t num_var, struct muCom_LinkedFunction_str *func_buf, uint16_t num_func) : muComBase(var_buf, num_var, func_buf, num_func), _transport(ser)
+				{	}
 		#endif
 };
 
@@ -0,0 +1,221 @@
+#include "muComCodec.h"
+#include "muComCore.h"
+#include <string.h>
+
+/*
+##### Bit layout #####
+The payload (index + data bytes) is treated as one big endian bit stream.
+The header byte holds the first 2 bits, every following byte the next 7 bits. Byte k >= 1 starts at stream bit 7 * k - 5.
+*/
+
+
+const uint8_t muCom_FrameLength[9] = {2, 3, 5, 6, 7, 8, 9, 10, 11};
+
+
+
+uint8_t muCom_getFrameLength(uint8_t header)
+{
+	//Read requests only contain the index, the data byte count is the number of bytes to be read
+	if((header & MUCOM_FRAME_DESC_MASK) == MUCOM_READ_REQUEST)
+	{
+		return 2;
+	}
+	return muCom_FrameLength[((header & MUCOM_DATA_BYTE_CNT_MASK) >> 2) + 1];
+}
+
+
+
+#ifdef __AVR__
+
+//64 bit shifts are expensive on AVR. Use unrolled 16 bit operations with constant shifts instead
+#define MUCOM_ENCODE_BYTE(k, pos, shift)		frame[k] = ((((uint16_t)payload[pos] << 8) | payload[pos + 1]) >> shift) & 0x7F
+#define MUCOM_DECODE_BYTE(k, pos, shift)		tmp = (uint16_t)(frame[k] & 0x7F) << shift; payload[pos] |= tmp >> 8; payload[pos + 1] |= (uint8_t)tmp
+
+
+uint8_t muCom_encodeFrame(uint8_t *frame, uint8_t frameDesc, uint8_t index, const uint8_t *data, uint8_t cnt)
+{
+	uint8_t payload[MUCOM_MAX_PAYLOAD_LEN + 1];
+
+	payload[0] = index;
+	memcpy(payload + 1, data, cnt);
+	memset(payload + 1 + cnt, 0, MUCOM_MAX_PAYLOAD_LEN - cnt);
+
+	frame[0] = MUCOM_HEADER_BIT_MASK | frameDesc | ((cnt - 1) << 2) | (payload[0] >> 6);
+	MUCOM_ENCODE_BYTE(1, 0, 7);
+	MUCOM_ENCODE_BYTE(2, 1, 8);
+	MUCOM_ENCODE_BYTE(3, 2, 9);
+	MUCOM_ENCODE_BYTE(4, 2, 2);
+	MUCOM_ENCODE_BYTE(5, 3, 3);
+	MUCOM_ENCODE_BYTE(6, 4, 4);
+	MUCOM_ENCODE_BYTE(7, 5, 5);
+	MUCOM_ENCODE_BYTE(8, 6, 6);
+	MUCOM_ENCODE_BYTE(9, 7, 7);
+	MUCOM_ENCODE_BYTE(10, 8, 8);
+
+	return muCom_getFrameLength(frame[0]);
+}
+
+
+
+void muCom_decodeFrame(const uint8_t *frame, uint8_t *payload)
+{
+	uint16_t tmp;
+
+	memset(payload + 1, 0, MUCOM_MAX_PAYLOAD_LEN - 1);
+	payload[0] = (frame[0] & 0x03) << 6;
+	MUCOM_DECODE_BYTE(1, 0, 7);
+	MUCOM_DECODE_BYTE(2, 1, 8);
+	MUCOM_DECODE_BYTE(3, 2, 9);
+	MUCOM_DECODE_BYTE(4, 2, 2);
+	MUCOM_DECODE_BYTE(5, 3, 3);
+	MUCOM_DECODE_BYTE(6, 4, 4);
+	MUCOM_DECODE_BYTE(7, 5, 5);
+	MUCOM_DECODE_BYTE(8, 6, 6);
+	MUCOM_DECODE_BYTE(9, 7, 7);
+	payload[8] |= frame[10] & 0x7F;
+}
+
+#else
+
+//The first 8 payload bytes fit into one 64 bit word. Only the last byte is handled separately
+uint8_t muCom_encodeFrame(uint8_t *frame, uint8_t frameDesc, uint8_t index, const uint8_t *data, uint8_t cnt)
+{
+	uint8_t payload[MUCOM_MAX_PAYLOAD_LEN];
+	uint64_t v;
+	uint8_t k;
+
+	payload[0] = index;
+	memcpy(payload + 1, data, cnt);
+	memset(payload + 1 + cnt, 0, MUCOM_MAX_PAYLOAD_LEN - 1 - cnt);
+
+	v = 0;
+	for(k = 0; k < 8; k++)
+	{
+		v = (v << 8) | payload[k];
+	}
+
+	frame[0] = MUCOM_HEADER_BIT_MASK | frameDesc | ((cnt - 1) << 2) | (uint8_t)(v >> 62);
+	for(k = 1; k <= 8; k++)
+	{
+		frame[k] = (uint8_t)(v >> (62 - 7 * k)) & 0x7F;
+	}
+	frame[9] = (uint8_t)((v << 1) | (payload[8] >> 7)) & 0x7F;
+	frame[10] = payload[8] & 0x7F;
+
+	return muCom_getFrameLength(frame[0]);
+}
+
+
+
+void muCom_decodeFrame(const uint8_t *frame, uint8_t *payload)
+{
+	uint64_t v;
+	uint8_t k;
+
+	v = (uint64_t)(frame[0] & 0x03) << 62;
+	for(k = 1; k <= 8; k++)
+	{
+		v |= (uint64_t)(frame[k] & 0x7F) << (62 - 7 * k);
+	}
+	v |= (frame[9] & 0x7F) >> 1;
+
+	payload[8] = (uint8_t)((frame[9] << 7) | (frame[10] & 0x7F));
+	for(k = 8; k != 0; k--)
+	{
+		payload[k - 1] = (uint8_t)v;
+		v >>= 8;
+	}
+}
+
+#endif
+
+
+
+uint8_t muCom_crc7(const uint8_t *data, uint8_t len)
+{
+	uint8_t crc = 0;
+	uint8_t i;
+
+	//The CRC is calculated left aligned, i.e. in bits 7-1
+	while(len != 0)
+	{
+		crc ^= *data++;
+		for(i = 0; i < 8; i++)
+		{
+			crc = (crc & 0x80) ? ((crc << 1) ^ 0x12) : (crc << 1);
+		}
+		len--;
+	}
+
+	return crc >> 1;
+}
+
+
+
+size_t muCom_encodeFrames(uint8_t *out, const struct muCom_Frame_str *frames, size_t num)
+{
+	size_t i, pos = 0;
+
+	for(i = 0; i < num; i++)
+	{
+		pos += muCom_encodeFrame(out + pos, frames[i].desc, frames[i].index, frames[i].data, frames[i].cnt);
+	}
+
+	return pos;
+}
+
+
+
+size_t muCom_decodeFrames(const uint8_t *in, size_t len, struct muCom_Frame_str *frames, size_t max, size_t *consumed)
+{
+	uint8_t frame[MUCOM_MAX_FRAME_LEN];
+	uint8_t payload[MUCOM_MAX_PAYLOAD_LEN];
+	size_t pos = 0, num = 0, i;
+	uint8_t frameLen;
+
+	while((pos < len) && (num < max))
+	{
+		if((in[pos] & MUCOM_HEADER_BIT_MASK) == 0)
+		{
+			//Waiting for the header... Discard any non-header bytes
+			pos++;
+			continue;
+		}
+
+		frameLen = muCom_getFrameLength(in[pos]);
+		if((pos + frameLen) > len)
+		{
+			break; //Incomplete frame
+		}
+
+		//A header inside the frame means that the frame was interrupted. Restart at the new header
+		for(i = 1; i < frameLen; i++)
+		{
+			if(in[pos + i] & MUCOM_HEADER_BIT_MASK)
+			{
+				break;
+			}
+		}
+		if(i < frameLen)
+		{
+			pos += i;
+			continue;
+		}
+
+		//Bytes after the end of the frame must not be read from the input
+		memcpy(frame, in + pos, frameLen);
+		memset(frame + frameLen, 0, MUCOM_MAX_FRAME_LEN - frameLen);
+		muCom_decodeFrame(frame, payload);
+
+		frames[num].desc = in[pos] & MUCOM_FRAME_DESC_MASK;
+		frames[num].cnt = ((in[pos] & MUCOM_DATA_BYTE_CNT_MASK) >> 2) + 1;
+		frames[num].index = payload[0];
+		memcpy(frames[num].data, payload + 1, 8);
+		num++;
+		pos += frameLen;
+	}
+
+	*consumed = pos;
+
+	return num;
+}
@@ -0,0 +1,103 @@
+/**
+	\brief		Encoder and decoder for muCom frames
+	\details	This file includes the functions converting between the payload of a frame (index + data bytes) and its 7 bit
+				representation on the wire (see muComCoreImpl.h for the frame structure).
+				The conversion is branch-free: 32/64 bit targets use a single 64 bit shift/mask path, AVR uses unrolled 16 bit operations.
+				Hosts may additionally encode and decode many frames per call.
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMCODEC_H
+#define MUCOMCODEC_H
+
+//Required includes
+#include <stdint.h>
+#include <stddef.h>
+
+#define MUCOM_MAX_FRAME_LEN		11	//!< Max. number of bytes of an encoded frame
+#define MUCOM_MAX_PAYLOAD_LEN	9	//!< Max. number of payload bytes of a frame (index + 8 data bytes)
+
+
+/**
+	\brief	Length of an encoded frame depending on its number of data bytes (index 1..8)
+*/
+extern const uint8_t muCom_FrameLength[9];
+
+
+/**
+	\brief	Decoded muCom frame used by the batch functions
+*/
+struct muCom_Frame_str
+{
+	uint8_t desc;		//Frame description (MUCOM_READ_RESPONSE, ...)
+	uint8_t index;		//Variable/function index
+	uint8_t cnt;		//Number of data bytes (1..8)
+	uint8_t data[8];	//Data bytes
+};
+
+
+/**
+	\brief		Get the length of a frame from its header byte
+	\param[in]	header	First byte of the frame
+	\return		Number of bytes of the complete frame
+*/
+uint8_t muCom_getFrameLength(uint8_t header);
+
+
+/**
+	\brief		Encode a single frame
+	\param[out]	frame		Buffer for the encoded frame (min. MUCOM_MAX_FRAME_LEN bytes)
+	\param[in]	frameDesc	Frame description (MUCOM_READ_RESPONSE, ...)
+	\param[in]	index		Variable/function index
+	\param[in]	data		Data bytes
+	\param[in]	cnt			Number of data bytes (1..8)
+	\return		Number of bytes of the encoded frame
+*/
+uint8_t muCom_encodeFrame(uint8_t *frame, uint8_t frameDesc, uint8_t index, const uint8_t *data, uint8_t cnt);
+
+
+/**
+	\brief		Decode the payload of a single frame
+	\details	All MUCOM_MAX_FRAME_LEN bytes of the frame buffer are read, bytes after the end of the frame only affect payload bytes after the end of the data.
+	\param[in]	frame		Encoded frame (min. MUCOM_MAX_FRAME_LEN bytes)
+	\param[out]	payload		Buffer for the payload (min. MUCOM_MAX_PAYLOAD_LEN bytes): index followed by the data bytes
+*/
+void muCom_decodeFrame(const uint8_t *frame, uint8_t *payload);
+
+
+/**
+	\brief		Calculate the CRC-7 (polynomial x^7 + x^3 + 1) of a frame
+	\details	Used as the last byte of frames in integrity mode (see muComCore::setCrc()).
+	\param[in]	data	Frame bytes
+	\param[in]	len		Number of bytes
+	\return		CRC (7 bit)
+*/
+uint8_t muCom_crc7(const uint8_t *data, uint8_t len);
+
+
+/**
+	\brief		Encode many frames back to back
+	\param[out]	out		Buffer for the encoded frames (min. num * MUCOM_MAX_FRAME_LEN bytes)
+	\param[in]	frames	Frames to be encoded
+	\param[in]	num		Number of frames
+	\return		Number of bytes written to the buffer
+*/
+size_t muCom_encodeFrames(uint8_t *out, const struct muCom_Frame_str *frames, size_t num);
+
+
+/**
+	\brief		Decode all complete frames of a received byte stream
+	\details	Bytes in front of a header and incomplete frames interrupted by a new header are discarded like in muComBase::handle().
+	\param[in]	in			Received bytes
+	\param[in]	len			Number of received bytes
+	\param[out]	frames		Buffer for the decoded frames
+	\param[in]	max			Max. number of frames to decode
+	\param[out]	consumed	Number of bytes processed. The remaining bytes belong to an incomplete frame and should be passed again together with the next data
+	\return		Number of decoded frames
+*/
+size_t muCom_decodeFrames(const uint8_t *in, size_t len, struct muCom_Frame_str *frames, size_t max, size_t *consumed);
+
+
+#endif //MUCOMCODEC_H
@@ -0,0 +1,1899 @@
+/**
+	\brief		Core of the muCom interface
+	\details	This file includes the class template that handles the protocol itself without the actual HW implementation neccessary to transmit and receive data.
+				The HW access is resolved at compile time (CRTP), so the compiler is able to inline the transport.
+				See muComBase for the classic class with virtual HW functions and muComStatic for a fully compile-time configured interface.
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMCORE_H
+#define MUCOMCORE_H
+
+//Required includes
+#include <stdint.h>
+#include <string.h>
+#include "muComCodec.h"
+
+#ifdef __AVR__
+	#pragma GCC optimize ("O2") //Roughly 4% more speed for 2% more flash usage compared to default "Os"
+#endif
+
+//Optional define for making muCom safe for being executed from different sources (e.g. loop() and a timer interrupt in parallel)
+//Deactivate for improved performance and slightly redused flash usage at own risk
+//#define MUCOM_DEACTIVATE_THREADLOCK
+
+//Optional define to remove support for discovery of linked variables and functions (see muComCore::discover())
+//Deactivating this functionality can be used in a closed system after debugging to save flash and RAM
+//#define MUCOM_DEACTIVATE_DISCOVERY
+
+//Optional define to remove support for bulk transfers of linked buffers larger than a single frame
+//#define MUCOM_DEACTIVATE_BULK
+
+//Optional define to remove support for subscriptions, i.e. linked variables being pushed to the communication partner without a read request
+//#define MUCOM_DEACTIVATE_SUBSCRIPTIONS
+
+//Optional define to remove support for checksummed frames with selective retransmission (see muComCore::setCrc())
+//#define MUCOM_DEACTIVATE_CRC
+
+//Optional define to remove support for statistics of the link (see muComCore::linkStats())
+//#define MUCOM_DEACTIVATE_STATS
+
+//Optional define to remove support for receiving data from an interrupt or a reader thread via a frame queue (see muComCore::setRxQueue())
+//#define MUCOM_DEACTIVATE_RX_QUEUE
+
+//Optional define to remove support for double-buffered linked variables (see muComBuffered)
+//#define MUCOM_DEACTIVATE_BUFFERED
+
+//Optional define to remove support for constant link tables located in flash (see muComCore::linkTable())
+//#define MUCOM_DEACTIVATE_CONST_TABLE
+
+//Optional define to remove support for collecting sent frames and writing them to the HW at once (see muComCore::setTxCoalescing())
+//#define MUCOM_DEACTIVATE_TX_COALESCING
+
+//Optional define to remove support for a transmit queue written to the HW without blocking (see muComCore::setTxQueue())
+//#define MUCOM_DEACTIVATE_TX_QUEUE
+
+//Optional define to remove support for atomic read-modify-write requests like fetch-and-add or compare-and-swap (see muComCore::modify())
+//#define MUCOM_DEACTIVATE_RMW
+
+//Optional define to remove support for capturing the data exchanged with the HW, e.g. into a trace file (see muComCore::setCapture())
+//#define MUCOM_DEACTIVATE_CAPTURE
+
+//Features that can be selected per interface via the FEATURES template parameter of muComCore (see muComStatic)
+//Features removed by the defines above can not be activated this way
+#define MUCOM_FEATURE_THREADLOCK	0x01	//!< Lock the interface while writing frames (see MUCOM_DEACTIVATE_THREADLOCK)
+#define MUCOM_FEATURE_DISCOVERY		0x02	//!< Discovery of linked variables and functions (see MUCOM_DEACTIVATE_DISCOVERY)
+#define MUCOM_FEATURE_BULK			0x04	//!< Bulk transfers (see MUCOM_DEACTIVATE_BULK)
+#define MUCOM_FEATURE_SUBSCRIPTIONS	0x08	//!< Subscriptions (see MUCOM_DEACTIVATE_SUBSCRIPTIONS)
+#define MUCOM_FEATURE_CRC			0x10	//!< Checksummed frames (see MUCOM_DEACTIVATE_CRC)
+#define MUCOM_FEATURE_STATS			0x20	//!< Statistics (see MUCOM_DEACTIVATE_STATS)
+#define MUCOM_FEATURE_RX_QUEUE		0x40	//!< Frame queue filled from an interrupt (see MUCOM_DEACTIVATE_RX_QUEUE)
+#define MUCOM_FEATURE_TX_QUEUE		0x80	//!< Non-blocking transmit queue (see MUCOM_DEACTIVATE_TX_QUEUE)
+#define MUCOM_FEATURE_PIPELINE		0x100	//!< Up to MUCOM_MAX_PENDING_READS read requests in flight instead of one (see muComCore::readAsync())
+#define MUCOM_FEATURE_TX_COALESCING	0x200	//!< Transmit frame coalescing (see MUCOM_DEACTIVATE_TX_COALESCING)
+
+#ifdef MUCOM_DEACTIVATE_THREADLOCK
+	#define MUCOM_DEFAULT_THREADLOCK	0
+#else
+	#define MUCOM_DEFAULT_THREADLOCK	MUCOM_FEATURE_THREADLOCK
+#endif
+#ifdef MUCOM_DEACTIVATE_DISCOVERY
+	#define MUCOM_DEFAULT_DISCOVERY		0
+#else
+	#define MUCOM_DEFAULT_DISCOVERY		MUCOM_FEATURE_DISCOVERY
+#endif
+#ifdef MUCOM_DEACTIVATE_BULK
+	#define MUCOM_DEFAULT_BULK			0
+#else
+	#define MUCOM_DEFAULT_BULK			MUCOM_FEATURE_BULK
+#endif
+#ifdef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+	#define MUCOM_DEFAULT_SUBSCRIPTIONS	0
+#else
+	#define MUCOM_DEFAULT_SUBSCRIPTIONS	MUCOM_FEATURE_SUBSCRIPTIONS
+#endif
+#ifdef MUCOM_DEACTIVATE_CRC
+	#define MUCOM_DEFAULT_CRC			0
+#else
+	#define MUCOM_DEFAULT_CRC			MUCOM_FEATURE_CRC
+#endif
+#ifdef MUCOM_DEACTIVATE_STATS
+	#define MUCOM_DEFAULT_STATS			0
+#else
+	#define MUCOM_DEFAULT_STATS			MUCOM_FEATURE_STATS
+#endif
+#ifdef MUCOM_DEACTIVATE_RX_QUEUE
+	#define MUCOM_DEFAULT_RX_QUEUE		0
+#else
+	#define MUCOM_DEFAULT_RX_QUEUE		MUCOM_FEATURE_RX_QUEUE
+#endif
+#ifdef MUCOM_DEACTIVATE_TX_QUEUE
+	#define MUCOM_DEFAULT_TX_QUEUE		0
+#else
+	#define MUCOM_DEFAULT_TX_QUEUE		MUCOM_FEATURE_TX_QUEUE
+#endif
+#ifdef MUCOM_DEACTIVATE_TX_COALESCING
+	#define MUCOM_DEFAULT_TX_COALESCING	0
+#else
+	#define MUCOM_DEFAULT_TX_COALESCING	MUCOM_FEATURE_TX_COALESCING
+#endif
+
+//All features not removed by the defines above
+#define MUCOM_FEATURES_DEFAULT	(MUCOM_DEFAULT_THREADLOCK | MUCOM_DEFAULT_DISCOVERY | MUCOM_DEFAULT_BULK | MUCOM_DEFAULT_SUBSCRIPTIONS | MUCOM_DEFAULT_CRC | MUCOM_DEFAULT_STATS \
+								| MUCOM_DEFAULT_RX_QUEUE | MUCOM_DEFAULT_TX_QUEUE | MUCOM_FEATURE_PIPELINE | MUCOM_DEFAULT_TX_COALESCING)
+
+//Features of muComBase and thus muCom and muComPosix. On AVR only the features of the original interface are selected to save RAM
+#ifndef MUCOM_BASE_FEATURES
+	#ifdef __AVR__
+		#define MUCOM_BASE_FEATURES	(MUCOM_DEFAULT_THREADLOCK | MUCOM_DEFAULT_DISCOVERY)
+	#else
+		#define MUCOM_BASE_FEATURES	MUCOM_FEATURES_DEFAULT
+	#endif
+#endif
+
+//Defines for the return values of the muCom interface functions
+#define MUCOM_OK			0	//!< OK. No error.
+#define MUCOM_ERR			-1	//!< Misc. error!
+#define MUCOM_ERR_TIMEOUT	-2	//!< Timeout occured (partner device not answering)
+#define MUCOM_ERR_COMM		-3	//!< Misc. communication error. Consider using one or two parity bits.
+#define MUCOM_PENDING		1	//!< Request is still being processed (no error)
+#define MUCOM_QUEUED		2	//!< Frame is queued and will be written to the HW later (no error)
+#define MUCOM_ERR_BUSY		-4	//!< Frame was not sent, as it would have to wait for the transmit buffer
+
+//Define default timeout of read requests via the interface
+#define MUCOM_DEFAULT_TIMEOUT		100	//!< Default read timeout in ms
+#define MUCOM_MIN_TIMEOUT			100	//!< Min. read timeout in us
+
+//Define the min. adaptive read timeout in us (see muComCore::setAdaptiveTimeout()). Lower it for fast links with little jitter
+#ifndef MUCOM_MIN_RTO
+	#define MUCOM_MIN_RTO			1000
+#endif
+
+//Define max. number of read requests that may be in flight at the same time (see muComCore::readAsync())
+#ifndef MUCOM_MAX_PENDING_READS
+	#ifdef __AVR__
+		#define MUCOM_MAX_PENDING_READS	4
+	#else
+		#define MUCOM_MAX_PENDING_READS	16
+	#endif
+#endif
+
+//Define the number of bytes read from the HW at once by muComCore::handle()
+#ifndef MUCOM_RX_CHUNK
+	#ifdef __AVR__
+		#define MUCOM_RX_CHUNK	16
+	#else
+		#define MUCOM_RX_CHUNK	256
+	#endif
+#endif
+
+//Define the number of bytes of sent frames collected for a single write to the HW (see muComCore::setTxCoalescing(), min. 13, max. 255)
+#ifndef MUCOM_TX_BUFFER
+	#ifdef __AVR__
+		#define MUCOM_TX_BUFFER	32
+	#else
+		#define MUCOM_TX_BUFFER	255
+	#endif
+#endif
+
+//Define the number of bytes buffered by the transmit queue (see muComCore::setTxQueue(), power of 2, min. MUCOM_TX_BUFFER + 26)
+#ifndef MUCOM_TX_QUEUE
+	#ifdef __AVR__
+		#define MUCOM_TX_QUEUE	64
+	#else
+		#define MUCOM_TX_QUEUE	1024
+	#endif
+#endif
+
+//Define the number of received frames buffered between muComCore::receive() and muComCore::handle() (power of 2, max. 128)
+#ifndef MUCOM_RX_QUEUE
+	#ifdef __AVR__
+		#define MUCOM_RX_QUEUE	4
+	#else
+		#define MUCOM_RX_QUEUE	64
+	#endif
+#endif
+
+//Index accesses of the frame queue shared by an interrupt or thread (producer) and handle() (consumer)
+#if defined(__AVR__)
+	//Single byte accesses are atomic. The barriers keep the compiler from moving the frame copy across the index access
+	#define MUCOM_LOAD_ACQUIRE(var)			__extension__ ({ uint8_t _v = *(volatile uint8_t*)&(var); __asm__ __volatile__("" ::: "memory"); _v; })
+	#define MUCOM_STORE_RELEASE(var, val)	do { __asm__ __volatile__("" ::: "memory"); *(volatile uint8_t*)&(var) = (val); } while(0)
+#else
+	#define MUCOM_LOAD_ACQUIRE(var)			__atomic_load_n(&(var), __ATOMIC_ACQUIRE)
+	#define MUCOM_STORE_RELEASE(var, val)	__atomic_store_n(&(var), (val), __ATOMIC_RELEASE)
+#endif
+
+//Memory barrier between the data accesses and the sequence counter of double-buffered variables (see muComBuffered)
+#if defined(__AVR__)
+	#define MUCOM_FENCE()	__asm__ __volatile__("" ::: "memory")
+#else
+	#define MUCOM_FENCE()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+//Access to constant link tables, which are located in flash on AVR (see muComCore::linkTable())
+#if defined(__AVR__)
+	#include <avr/pgmspace.h>
+	#define MUCOM_PROGMEM					PROGMEM
+	#define MUCOM_PGM_INDEX(entry)			pgm_read_word(&(entry)->index)
+	#define MUCOM_PGM_COPY(dst, src, len)	memcpy_P((dst), (src), (len))
+#else
+	#define MUCOM_PROGMEM
+	#define MUCOM_PGM_INDEX(entry)			((entry)->index)
+	#define MUCOM_PGM_COPY(dst, src, len)	memcpy((dst), (src), (len))
+#endif
+
+//Results of the frame assembly
+#define MUCOM_RX_NONE		0	//Frame not complete yet
+#define MUCOM_RX_FRAME		1	//Frame complete
+#define MUCOM_RX_ERROR		2	//Truncated frame or data without header
+#define MUCOM_RX_PREFIX		3	//Truncated frame which might have been a MUCOM_EXT_PAGE or MUCOM_EXT_OFFSET prefix
+
+//Define max. number of variables that can be read with a single batch read request (see muComCore::readBatch())
+#ifndef MUCOM_MAX_BATCH_READ
+	#ifdef __AVR__
+		#define MUCOM_MAX_BATCH_READ	7
+	#else
+		#define MUCOM_MAX_BATCH_READ	16
+	#endif
+#endif
+
+//Various defines for the interface itself
+#define MUCOM_HEADER_BIT_MASK		0x80
+#define MUCOM_FRAME_DESC_MASK		0x60
+#define MUCOM_DATA_BYTE_CNT_MASK	0x1C
+#define MUCOM_READ_RESPONSE			0x00
+#define MUCOM_READ_REQUEST			0x20
+#define MUCOM_WRITE_REQUEST			0x40
+#define MUCOM_EXECUTE_REQUEST		0x60
+
+//Extended frames are execute requests to the reserved index MUCOM_EXT_INDEX. The first data byte holds the opcode
+#define MUCOM_EXT_INDEX				0xFF
+#define MUCOM_EXT_READ_LIST			0x01
+#define MUCOM_EXT_READ_RANGE		0x02
+#define MUCOM_EXT_BULK_READ			0x03
+#define MUCOM_EXT_BULK_WRITE		0x04
+#define MUCOM_EXT_BULK_DATA			0x05
+#define MUCOM_EXT_BULK_ACK			0x06
+#define MUCOM_EXT_BULK_ABORT		0x07
+#define MUCOM_EXT_SUBSCRIBE			0x08
+#define MUCOM_EXT_UNSUBSCRIBE		0x09
+#define MUCOM_EXT_NACK				0x0A
+#define MUCOM_EXT_DISCOVER			0x0B
+#define MUCOM_EXT_TABLE_VAR			0x0C
+#define MUCOM_EXT_TABLE_FUNC		0x0D
+#define MUCOM_EXT_TABLE_HASH		0x0E
+#define MUCOM_EXT_PAGE				0x0F
+#define MUCOM_EXT_TABLE_FUNC_PAGE	0x10
+#define MUCOM_EXT_RMW				0x11
+#define MUCOM_EXT_RMW_ARG			0x12
+#define MUCOM_EXT_OFFSET			0x13
+#define MUCOM_EXT_RMW_REJECT		0x14
+#define MUCOM_EXT_READ_REJECT		0x15
+#define MUCOM_EXT_MAX_ARGS			7
+
+//Defines for bulk transfers
+#define MUCOM_BULK_CHUNK			6	//!< Data bytes per bulk data frame
+#define MUCOM_BULK_RETRIES			3	//!< Max. number of timeouts without progress before a bulk transfer is aborted
+#define MUCOM_BULK_FLAG_INITIATOR	0x01
+#define MUCOM_BULK_FLAG_NACKED		0x02
+
+//Defines for subscriptions
+#define MUCOM_SUBSCRIBE_PERIODIC	0x00	//!< Push the variable periodically
+#define MUCOM_SUBSCRIBE_ON_CHANGE	0x01	//!< Push the variable whenever it changes, but not more often than the period
+#define MUCOM_DEADBAND_ABSOLUTE		0x00	//!< Deadband is an absolute difference
+#define MUCOM_DEADBAND_RELATIVE		0x01	//!< Deadband is a fraction of the last pushed value
+#define MUCOM_SUB_FLAG_ACTIVE		0x80
+#define MUCOM_SUB_FLAG_FORCE		0x40
+#ifndef MUCOM_MAX_SUBSCRIPTIONS
+	#ifdef __AVR__
+		#define MUCOM_MAX_SUBSCRIPTIONS	4	//!< Max. number of variables the communication partner can subscribe to
+	#else
+		#define MUCOM_MAX_SUBSCRIPTIONS	16	//!< Max. number of variables the communication partner can subscribe to
+	#endif
+#endif
+#ifndef MUCOM_MIN_SUB_PERIOD
+	#ifdef __AVR__
+		#define MUCOM_MIN_SUB_PERIOD	10	//!< Min. push period of periodic subscriptions in ms
+	#else
+		#define MUCOM_MIN_SUB_PERIOD	1	//!< Min. push period of periodic subscriptions in ms
+	#endif
+#endif
+#ifndef MUCOM_BULK_WINDOW
+	#ifdef __AVR__
+		#define MUCOM_BULK_WINDOW	4	//!< Default number of unacknowledged bulk data frames (max. 127)
+	#else
+		#define MUCOM_BULK_WINDOW	32	//!< Default number of unacknowledged bulk data frames (max. 127)
+	#endif
+#endif
+
+
+//Defines for checksummed frames
+#define MUCOM_CRC_LEN				2	//!< Number of bytes appended to each frame (sequence number and CRC)
+#define MUCOM_CRC_RETRIES			3	//!< Max. number of repeated NACKs before a missing frame is skipped
+#ifndef MUCOM_CRC_FRAMES
+	#ifdef __AVR__
+		#define MUCOM_CRC_FRAMES	4	//!< Number of sent frames kept for retransmission (power of 2, max. 32)
+	#else
+		#define MUCOM_CRC_FRAMES	16	//!< Number of sent frames kept for retransmission (power of 2, max. 32)
+	#endif
+#endif
+
+//Defines for statistics
+#define MUCOM_STATS_BUCKETS			16	//!< Number of buckets of the read latency histogram
+#ifndef MUCOM_STATS_INDICES
+	#ifdef __AVR__
+		#define MUCOM_STATS_INDICES	16	//!< Number of linked variables with access counters, starting at index 0
+	#else
+		#define MUCOM_STATS_INDICES	64	//!< Number of linked variables with access counters, starting at index 0
+	#endif
+#endif
+
+//Operations of read-modify-write requests (see muComCore::modify())
+#define MUCOM_RMW_ADD				0x00	//!< Add the operand (wraps around)
+#define MUCOM_RMW_CAS				0x01	//!< Store the operand if the variable equals the compare value
+#define MUCOM_RMW_SET				0x02	//!< Set the bits of the operand
+#define MUCOM_RMW_CLEAR				0x03	//!< Clear the bits of the operand
+#define MUCOM_RMW_TOGGLE			0x04	//!< Toggle the bits of the operand
+#define MUCOM_RMW_MIN				0x05	//!< Store the operand if it is smaller, i.e. clamp to an upper limit
+#define MUCOM_RMW_MAX				0x06	//!< Store the operand if it is greater, i.e. clamp to a lower limit
+#define MUCOM_RMW_SIGNED			0x80	//!< Flag: Compare signed values (MUCOM_RMW_MIN and MUCOM_RMW_MAX)
+
+//Types of captured data (see muComCore::setCapture())
+#define MUCOM_CAPTURE_RX			0x01	//!< Raw bytes read from the HW
+#define MUCOM_CAPTURE_TX			0x02	//!< Raw bytes written to the HW
+#define MUCOM_CAPTURE_FRAME_RX		0x03	//!< Decoded frame executed by the interface (header without sync bit, index byte, data bytes)
+#define MUCOM_CAPTURE_FRAME_TX		0x04	//!< Decoded frame sent by the interface (header without sync bit, index byte, data bytes)
+
+//Defines for discovery
+#define MUCOM_DISCOVER_HASH			0x00	//!< Only request the hash of the table
+#define MUCOM_DISCOVER_TABLE		0x01	//!< Request the whole table
+#ifndef MUCOM_MAX_TABLE
+	#ifdef __AVR__
+		#define MUCOM_MAX_TABLE		16	//!< Max. number of remote variables and functions stored by discover()
+	#else
+		#define MUCOM_MAX_TABLE		255	//!< Max. number of remote variables and functions stored by discover()
+	#endif
+#endif
+
+
+/**
+	\brief	Standard variable constants that can be linked via MUCOM
+*/
+enum muCom_LinkedVariableType : uint8_t
+{
+	MUCOM_INT8	 = 0,
+	MUCOM_INT16	 = 1,
+	MUCOM_INT32	 = 2,
+	MUCOM_INT64	 = 3,
+	MUCOM_UINT8	 = 4,
+	MUCOM_UINT16 = 5,
+	MUCOM_UINT32 = 6,
+	MUCOM_UINT64 = 7,
+	MUCOM_FLOAT	 = 8,
+	MUCOM_DOUBLE = 9,
+	MUCOM_ARRAY	 = 10
+};
+
+
+/**
+	\brief	Linked variable of the communication partner (see muComCore::discover())
+*/
+struct muCom_RemoteVariable_str
+{
+	uint16_t size;					//!< Linked size in bytes
+	uint16_t index;					//!< Index of the variable
+	muCom_LinkedVariableType type;	//!< Type of the variable
+};
+
+
+/**
+	\brief		Table of the linked variables and functions of the communication partner (see muComCore::discover())
+	\details	The structure contains no pointers and may be stored as it is, e.g. to skip the discovery if the hash did not change.
+*/
+struct muCom_Table_str
+{
+	uint32_t hash;											//!< Hash of the table (see muComCore::readTableHash())
+	uint8_t num_var;										//!< Number of linked variables
+	uint8_t num_func;										//!< Number of linked functions
+	struct muCom_RemoteVariable_str var[MUCOM_MAX_TABLE];	//!< Linked variables in ascending order of their indices
+	uint16_t func[MUCOM_MAX_TABLE];							//!< Indices of the linked functions in ascending order
+};
+
+
+/**
+	\brief	Internal structure to store the deadbands of linked variables being pushed to the communication partner
+*/
+struct muCom_PublishedVariable_str
+{
+	float deadband;			//Min. change of the value to be pushed again (0 = any change)
+	uint8_t flags;			//MUCOM_DEADBAND_ABSOLUTE or MUCOM_DEADBAND_RELATIVE
+};
+
+
+/**
+	\brief	Function prototype for functions that can be invoked by the muCom interface
+*/
+typedef void (*muComFunc)(uint8_t *data, uint8_t cnt);
+
+
+/**
+	\brief	Function prototype for functions receiving variables pushed by the communication partner (see muComCore::subscribe())
+*/
+typedef void (*muComPushFunc)(uint8_t index, uint8_t *data, uint8_t cnt);
+
+/**
+	\brief	Function prototype for functions notified when frames can be sent without blocking again (see muComCore::tryWrite())
+*/
+typedef void (*muComTxReadyFunc)(uint16_t space);
+
+/**
+	\brief	Function prototype for functions receiving the data exchanged with the HW (see muComCore::setCapture())
+	\param[in]	ctx		Context pointer passed to setCapture()
+	\param[in]	type	MUCOM_CAPTURE_...
+	\param[in]	data	Captured bytes (only valid while the function is executed)
+	\param[in]	cnt		Number of captured bytes
+*/
+typedef void (*muComCaptureFunc)(void *ctx, uint8_t type, const uint8_t *data, uint16_t cnt);
+
+
+/**
+	\brief	Internal structure to store references to linked variables
+*/
+struct muCom_LinkedVariable_str
+{
+	void* addr;
+	uint16_t size;
+	uint16_t index;			//Index used by the communication partner. The entries are sorted by it
+	#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		muCom_LinkedVariableType type;
+	#endif
+	#ifndef MUCOM_DEACTIVATE_BUFFERED
+		volatile uint8_t *seq;	//Sequence counter of a double-buffered variable or NULL
+	#endif
+};
+
+
+/**
+	\brief	Internal structure to store references to linked functions
+*/
+struct muCom_LinkedFunction_str
+{
+	muComFunc func;
+	uint16_t index;			//Index used by the communication partner. The entries are sorted by it
+};
+
+
+//Types of linked variables for discovery
+static constexpr muCom_LinkedVariableType muCom_typeOf(const int8_t*)			{	return MUCOM_INT8;		}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const int16_t*)			{	return MUCOM_INT16;		}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const int32_t*)			{	return MUCOM_INT32;		}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const int64_t*)			{	return MUCOM_INT64;		}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const uint8_t*)			{	return MUCOM_UINT8;		}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const uint16_t*)			{	return MUCOM_UINT16;	}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const uint32_t*)			{	return MUCOM_UINT32;	}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const uint64_t*)			{	return MUCOM_UINT64;	}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const float*)			{	return MUCOM_FLOAT;		}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const double*)			{	return MUCOM_DOUBLE;	}
+static constexpr muCom_LinkedVariableType muCom_typeOf(const void*)				{	return MUCOM_ARRAY;		}
+
+
+//Optional members of an entry of a constant link table
+#ifndef MUCOM_DEACTIVATE_DISCOVERY
+	#define MUCOM_ENTRY_TYPE(type)		, (type)
+#else
+	#define MUCOM_ENTRY_TYPE(type)
+#endif
+#ifndef MUCOM_DEACTIVATE_BUFFERED
+	#define MUCOM_ENTRY_SEQ(seq)		, (seq)
+#else
+	#define MUCOM_ENTRY_SEQ(seq)
+#endif
+
+//Entries of constant link tables (see muComCore::linkTable()). The entries must be sorted by index
+#define MUCOM_VAR(index, var)			{ &(var), sizeof(var), (index) MUCOM_ENTRY_TYPE(muCom_typeOf(&(var))) MUCOM_ENTRY_SEQ(NULL) }
+#define MUCOM_BUFFERED_VAR(index, var)	{ (var).buf, sizeof((var).buf[0]), (index) MUCOM_ENTRY_TYPE(muCom_typeOf(&(var).buf[0])) MUCOM_ENTRY_SEQ(&(var).seq) }
+#define MUCOM_FUNC(index, func)			{ (func), (index) }
+
+
+//Check whether the entries first to last - 1 of a link table have a higher index than their predecessors (divided in halves to limit the recursion depth)
+template<typename T, size_t N>
+constexpr bool muCom_isAscending(const T (&table)[N], size_t first, size_t last)
+{
+	return ((last - first) > 1)
+		? (muCom_isAscending(table, first, first + (last - first) / 2) && muCom_isAscending(table, first + (last - first) / 2, last))
+		: ((first >= last) || (table[first - 1].index < table[first].index));
+}
+
+
+//Check whether the indices of a link table are sorted and unique
+template<typename T, size_t N>
+constexpr bool muCom_isSorted(const T (&table)[N])
+{
+	return muCom_isAscending(table, 1, N);
+}
+
+
+/**
+	\brief		Check a constant link table at compile time
+	\details	Fails to compile if the indices of the table are not ascending, e.g. if two entries use the same index.
+	\param[in]	table	Array of muCom_LinkedVariable_str or muCom_LinkedFunction_str declared as constexpr
+*/
+#define MUCOM_CHECK_TABLE(table)	static_assert(muCom_isSorted(table), "Indices of " #table " must be ascending and unique")
+
+
+#ifndef MUCOM_DEACTIVATE_BUFFERED
+/**
+	\brief		Double-buffered variable to be linked to a muCom interface
+	\details	The variable holds two copies of the value and a sequence counter selecting the valid one.
+				The writer updates the other copy and increments the counter afterwards, so readers never see a partially written value
+				and the interface neither masks interrupts nor waits for the writer. A reader only retries if the value was updated while it copied it.
+				Each variable must have a single writer: Either the communication partner via write requests (read with get(), e.g. in an ISR)
+				or the application via set() (read by the communication partner).
+	\tparam		T	Type of the value
+*/
+template<typename T>
+struct muComBuffered
+{
+	T buf[2];				//!< Both copies of the value. buf[seq & 1] is the valid one
+	volatile uint8_t seq;	//!< Number of updates
+	
+	/**
+		\brief		Update the value (single writer only)
+		\param[in]	value	New value
+	*/
+	inline void set(const T &value)
+	{
+		uint8_t next = this->seq + 1;
+		
+		//The old copy is not written before the previous update of the counter. A reader still copying it
+		//does not wait for, but notices the change by the counter and retries
+		MUCOM_FENCE();
+		memcpy((void*)&this->buf[next & 1], &value, sizeof(T));
+		MUCOM_STORE_RELEASE(this->seq, next);
+	}
+	
+	/**
+		\brief		Get a consistent copy of the value
+		\return		Current value
+	*/
+	inline T get(void) const
+	{
+		T value;
+		uint8_t current;
+		
+		do
+		{
+			current = MUCOM_LOAD_ACQUIRE(this->seq);
+			memcpy(&value, (const void*)&this->buf[current & 1], sizeof(T));
+			MUCOM_FENCE();
+		} while(current != this->seq);
+		
+		return value;
+	}
+};
+#endif
+
+
+/**
+	\brief	Internal structure to store read requests waiting for their response
+*/
+struct muCom_PendingRead_str
+{
+	uint8_t* data;			//Destination of the read data. NULL if the slot is unused
+	uint32_t time_start;	//Timestamp the request was sent
+	uint32_t timeout;		//Timeout in us, fixed when the request was sent
+	uint16_t index;			//Index of the remote variable
+	uint8_t size;			//Number of requested data bytes
+	uint8_t order;			//Sequence number to answer requests of the same index in order
+	int8_t status;			//MUCOM_PENDING or the result of the request
+	uint8_t reject;			//Opcode of the frame rejecting the request (MUCOM_EXT_READ_REJECT or MUCOM_EXT_RMW_REJECT)
+	uint8_t ambiguous;		//1 if a late response of the index was dropped meanwhile. It might have been the response of this request
+};
+
+
+/**
+	\brief	Internal structure to store a read request which timed out. Its response may still arrive
+*/
+struct muCom_LateRead_str
+{
+	uint32_t time_out;		//Timestamp the request timed out
+	uint16_t index;			//Index of the remote variable
+	uint8_t order;			//Sequence number of the request (see muCom_PendingRead_str)
+	uint8_t reject;			//Opcode of the frame rejecting the request (see muCom_PendingRead_str)
+	uint8_t used;			//1 if the response is still expected
+};
+
+
+/**
+	\brief	Internal structure to store the state of one direction of a bulk transfer
+*/
+struct muCom_BulkTransfer_str
+{
+	uint8_t* addr;			//Local data of the transfer. NULL if no transfer was started
+	uint16_t len;			//Total number of data bytes
+	uint16_t offset;		//Offset inside the remote buffer (only used by the initiator)
+	uint16_t next;			//Sender: Next chunk to be sent, receiver: Next chunk expected
+	uint16_t acked;			//Number of chunks acknowledged by the receiver
+	uint32_t time;			//Timestamp of the last progress
+	uint8_t index;			//Index of the remote buffer (only used by the initiator)
+	uint8_t window;			//Max. number of unacknowledged chunks
+	uint8_t retries;		//Number of timeouts without progress
+	uint8_t flags;			//See MUCOM_BULK_FLAG_...
+	int8_t status;			//MUCOM_PENDING or the result of the transfer
+};
+
+
+/**
+	\brief		Statistics of a muCom interface (see muComCore::linkStats())
+	\details	Only 32 bit counters are used, so the structure has the same layout on all platforms and can be read by the communication partner.
+*/
+struct muCom_Stats_str
+{
+	uint32_t frames_sent;						//!< Frames written to the HW including retransmissions
+	uint32_t frames_received;					//!< Valid frames received
+	uint32_t bytes_discarded;					//!< Bytes discarded while resynchronizing, e.g. remainders of corrupted frames
+	uint32_t timeouts;							//!< Read requests and bulk transfers that timed out and frames not sent due to a full transmit buffer
+	uint32_t comm_errors;						//!< Read responses with a wrong size and frames with a wrong CRC
+	uint32_t tx_waits;							//!< Number of times writing had to wait for the transmit buffer
+	uint32_t retransmits;						//!< Frames retransmitted on request of the communication partner (see setCrc())
+	uint32_t latency[MUCOM_STATS_BUCKETS];		//!< Read round-trip times. Bucket 0: 0 us, bucket n: 2^(n-1) to 2^n - 1 us, last bucket: everything above
+	uint32_t access[MUCOM_STATS_INDICES];		//!< Read and write requests of the communication partner per linked variable
+};
+
+
+/**
+	\brief	Internal structure to store a variable the communication partner subscribed to
+*/
+struct muCom_Subscription_str
+{
+	uint32_t last;			//Timestamp of the last push
+	uint16_t period;		//Push period or min. time between two pushes in ms
+	uint8_t index;			//Index of the linked variable
+	uint8_t flags;			//Subscription mode and MUCOM_SUB_FLAG_...
+	uint8_t shadow[8];		//Value of the last push
+};
+
+
+//Number of entries of the storage of a feature (only used within muComCore). Features not selected via FEATURES keep a single unused entry
+#define MUCOM_FEATURE_SIZE(feature, num)	((FEATURES & (feature)) ? (num) : 1)
+#define MUCOM_PENDING_SLOTS		MUCOM_FEATURE_SIZE(MUCOM_FEATURE_PIPELINE, MUCOM_MAX_PENDING_READS)
+#define MUCOM_SUB_SLOTS			MUCOM_FEATURE_SIZE(MUCOM_FEATURE_SUBSCRIPTIONS, MUCOM_MAX_SUBSCRIPTIONS)
+#define MUCOM_CRC_SLOTS			MUCOM_FEATURE_SIZE(MUCOM_FEATURE_CRC, MUCOM_CRC_FRAMES)
+#define MUCOM_RXQ_SLOTS			MUCOM_FEATURE_SIZE(MUCOM_FEATURE_RX_QUEUE, MUCOM_RX_QUEUE)
+#define MUCOM_TXQ_SIZE			MUCOM_FEATURE_SIZE(MUCOM_FEATURE_TX_QUEUE, MUCOM_TX_QUEUE)
+#define MUCOM_TXBUF_SIZE		MUCOM_FEATURE_SIZE(MUCOM_FEATURE_TX_COALESCING, MUCOM_TX_BUFFER)
+
+
+/**
+	\brief		Core muCom class template
+	\details	This class implements the muCom protocol itself and relies on being inherited in order to implement the actual serial interface (CRTP).
+				The derived class has to provide the following HW functions, which are called without virtual dispatch:
+				<br>void _write(uint8_t* data, uint8_t cnt): Write data to the HW
+				<br>uint8_t _read(void): Read a single byte from the HW
+				<br>uint16_t _available(void): Number of bytes available from the HW (uint8_t for classes derived from muComBase)
+				<br>uint16_t _readBuffer(uint8_t *data, uint16_t max): Read all available data (max. "max" bytes) from the HW at once
+				<br>uint8_t _availableTxBuffer(void): Number of bytes free in the transmit buffer of the HW
+				<br>void _flushTx(void): Wait until all written bytes are actually transmitted
+				<br>uint32_t _getTimestamp(void): Current timestamp in ms
+				<br>uint32_t _getTimestampUs(void): Current timestamp in us (used for all timeouts)
+				<br>void _disableInterrupts(void) and void _enableInterrupts(void): Lock and unlock the interface
+				<br>All state including the frame parser is kept in the object and the library has no mutable global data,
+				so any number of interfaces may be used concurrently, e.g. one per thread or several links on one MCU.
+	\tparam		Derived		Class implementing the HW functions
+	\tparam		FEATURES	Combination of MUCOM_FEATURE_... flags. Deactivated features are removed by the compiler and their buffers shrink to a single entry
+*/
+template<class Derived, uint16_t FEATURES = MUCOM_FEATURES_DEFAULT>
+class muComCore
+{
+	private:
+		struct muCom_LinkedVariable_str *_linked_var;	//Array of all linked variables, sorted by index
+		uint16_t _linked_var_num;						//Max. number of linked variables
+		uint16_t _linked_var_cnt;						//Number of linked variables
+		struct muCom_LinkedFunction_str *_linked_func;	//Array of all linked functions, sorted by index
+		uint16_t _linked_func_num;						//Max. number of linked functions
+		uint16_t _linked_func_cnt;						//Number of linked functions
+		#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+			const struct muCom_LinkedVariable_str *_const_var;	//Constant table of linked variables, sorted by index (see linkTable())
+			uint16_t _const_var_cnt;							//Number of entries of the constant table of linked variables
+			const struct muCom_LinkedFunction_str *_const_func;	//Constant table of linked functions, sorted by index
+			uint16_t _const_func_cnt;							//Number of entries of the constant table of linked functions
+		#endif
+		uint8_t _rx_page;								//Upper byte of the index of the next received frame (see MUCOM_EXT_PAGE)
+		uint16_t _rx_offset;							//Byte offset of the next received read or write request (see MUCOM_EXT_OFFSET)
+		uint8_t _rx_skip;								//1 if frames were lost in front of the next received frame. It might have lost its prefix
+		uint8_t _rcv_buf[MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];	//Internal receive buffer
+		uint8_t _rcv_buf_cnt;							//Number of valid bytes in the internal receive buffer (serves as statemachine)
+		uint32_t _timeout;								//Timeout for read requests in us
+		uint32_t _srtt;									//Smoothed round-trip time of read requests in us (0 = no sample yet)
+		uint32_t _rttvar;								//Mean deviation of the round-trip time in us
+		uint32_t _rto;									//Adaptive timeout for read requests in us
+		uint8_t _adaptive;								//1 if read requests use the adaptive timeout
+		uint32_t _lastCommTime;							//Timestamp of last successful communication
+		struct muCom_PendingRead_str _pending[MUCOM_PENDING_SLOTS];	//Read requests waiting for their response
+		uint8_t _pending_order;							//Sequence number of the next read request
+		struct muCom_LateRead_str _late[MUCOM_PENDING_SLOTS];	//Timed out read requests. Their responses are dropped for max. the timeout
+		
+		//Write a raw muCom frame accessing a linked variable at a byte offset. Preceded by a MUCOM_EXT_OFFSET or MUCOM_EXT_PAGE frame if needed
+		int8_t _writeRaw(uint8_t frameDesc, uint16_t index, uint16_t offset, uint8_t *data, uint8_t cnt);
+		
+		//Write a raw muCom frame. Indices above 255 are preceded by a MUCOM_EXT_PAGE frame
+		inline int8_t writeRaw(uint8_t frameDesc, uint16_t index, uint8_t *data, uint8_t cnt)
+			{	return this->_writeRaw(frameDesc, index, 0, data, cnt);	}
+		
+		//Write a raw muCom frame only if it can be sent without waiting for the HW
+		int8_t _tryWriteRaw(uint8_t frameDesc, uint16_t index, uint8_t *data, uint8_t cnt);
+		
+		//Send the upper byte of the index and the byte offset of the next frame if needed. Must be called while the interface is locked
+		void _sendPrefix(uint16_t index, uint16_t offset);
+		
+		//Find a linked variable. Entries of the constant table are copied to "buf". NULL if nothing is linked to the index
+		const struct muCom_LinkedVariable_str* _findVar(uint16_t index, struct muCom_LinkedVariable_str *buf);
+		
+		//Find a linked function. NULL if nothing is linked to the index
+		muComFunc _findFunc(uint16_t index);
+		
+		//Wait for sufficient space in the transmit buffer and lock the interface
+		int8_t _lockTx(void);
+		
+		//Lock the interface without waiting for space in the transmit buffer
+		void _lockTxNoWait(void);
+		
+		//Unlock the interface after writing
+		void _unlockTx(void);
+		
+		//Write an encoded frame. Must be called while the interface is locked
+		void _send(uint8_t *frame, uint8_t len);
+		
+		//Write an encoded frame to the HW or add it to the transmit buffer. Must be called while the interface is locked
+		void _output(const uint8_t *frame, uint8_t len);
+		
+		//1 if the next frame is only added to the transmit buffer, i.e. nothing is written to the HW
+		uint8_t _txCollecting(void);
+		
+		//Number of bytes in the transmit buffer (see setTxCoalescing())
+		uint8_t _txCollected(void);
+		
+		//Execute a received frame
+		uint8_t _dispatch(const uint8_t *frame);
+		
+		//Linked variable of an index starting at a byte offset. NULL if "cnt" bytes at the offset exceed the linked size
+		const struct muCom_LinkedVariable_str* _findVarAt(uint16_t index, uint16_t offset, uint8_t cnt, struct muCom_LinkedVariable_str *buf);
+		
+		//Copy the value of a linked variable. Double-buffered variables are always consistent, others only if "lock" is set
+		void _loadVar(const struct muCom_LinkedVariable_str *var, uint8_t *data, uint8_t cnt, uint8_t lock);
+		
+		//Write to a linked variable. Interrupts are masked while writing if "lock" is set
+		void _storeVar(const struct muCom_LinkedVariable_str *var, const uint8_t *data, uint8_t cnt, uint8_t lock);
+		
+		//Hand a received read response over to the oldest matching read request. "reject" is 0 for a response, otherwise the opcode
+		//of the received reject frame, which only completes requests of that kind with MUCOM_ERR
+		uint8_t _completeRead(uint16_t index, uint8_t *data, uint8_t cnt, uint8_t reject);
+		
+		//Remember a timed out read request, so its late response is dropped. Interrupts must be disabled
+		void _addLate(uint8_t tag);
+		
+		//Update the round-trip time estimation with a new sample
+		void _updateRtt(uint32_t rtt);
+		
+		//Current timeout of read requests in us
+		inline uint32_t _readTimeout(void)
+			{	return this->_adaptive ? this->_rto : this->_timeout;	}
+		
+		//Reserve a slot for a read request
+		int8_t _allocRead(uint16_t index, uint8_t *data, uint8_t cnt);
+		
+		//Answer a read request for bytes outside the linked variable
+		void _rejectRead(uint16_t index);
+		
+		//Execute a received extended frame
+		void _handleExtended(uint8_t *data, uint8_t cnt);
+		
+		//Send a consistent snapshot of the given linked variables
+		void _sendSnapshot(uint8_t *index, uint8_t num);
+		
+		#ifndef MUCOM_DEACTIVATE_BULK
+			struct muCom_BulkTransfer_str _bulk_tx;		//Bulk transfer sent by this interface
+			struct muCom_BulkTransfer_str _bulk_rx;		//Bulk transfer received by this interface
+			uint8_t _bulk_window;						//Window used for bulk transfers initiated by this interface
+			
+			//Handle received bulk transfer frames
+			void _handleBulk(uint8_t *data, uint8_t cnt);
+			
+			//Send pending bulk data frames and handle timeouts
+			void _processBulk(void);
+			
+			//Send an acknowledge for the received chunks
+			void _sendBulkAck(uint8_t retransmit);
+			
+			//Send the request starting a bulk transfer
+			void _sendBulkRequest(uint8_t opcode, struct muCom_BulkTransfer_str *bulk);
+			
+			//Wait for a bulk transfer to be finished
+			int8_t _waitBulk(struct muCom_BulkTransfer_str *bulk);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_RMW
+			uint8_t _rmw_arg[4];						//Compare value of the next read-modify-write request (see MUCOM_EXT_RMW_ARG)
+			uint8_t _rmw_arg_cnt;						//Size of the compare value (0 = none)
+			uint8_t _rmw_arg_index;						//Index of the variable the compare value belongs to
+			
+			//Execute a received read-modify-write request and answer with the previous value
+			void _handleRmw(uint8_t *data, uint8_t cnt);
+			
+			//Answer an invalid read-modify-write request
+			void _rejectRmw(uint8_t index);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_CAPTURE
+			muComCaptureFunc _capture_func;				//Function receiving the data exchanged with the HW or NULL
+			void *_capture_ctx;							//Context pointer passed to the function above
+			
+			//Pass a decoded frame to the capture function
+			void _captureFrame(uint8_t type, const uint8_t *frame);
+		#endif
+		
+		muComPushFunc _push_func;						//Function receiving read responses nobody was waiting for
+		muComTxReadyFunc _tx_ready_func;				//Function notified when frames can be sent without blocking again
+		uint8_t _tx_busy;								//1 if a frame was rejected by tryWrite() since the last notification
+		
+		#ifndef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+			struct muCom_Subscription_str _subs[MUCOM_SUB_SLOTS];	//Variables the communication partner subscribed to
+			struct muCom_PublishedVariable_str *_published;				//Array of deadbands of linked variables or NULL
+			uint8_t _published_num;										//Number of entries in the array above
+			
+			//Check whether a variable changed by more than its deadband (if any) since the last push
+			uint8_t _hasChanged(const struct muCom_LinkedVariable_str *var, const struct muCom_Subscription_str *sub, uint8_t *value, uint8_t size);
+			
+			//Handle received subscription requests
+			void _handleSubscription(uint8_t *data, uint8_t cnt);
+			
+			//Push all subscribed variables that are due
+			void _processSubscriptions(void);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_CRC
+			uint8_t _crc;								//1 if checksummed frames are used
+			uint8_t _tx_seq;							//Sequence number of the next frame to be sent
+			uint8_t _tx_ring[MUCOM_CRC_SLOTS][MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];	//Sent frames kept for retransmission
+			uint8_t _rx_next;							//Sequence number of the next frame to be executed
+			uint8_t _rx_high;							//Sequence number following the newest frame received or requested
+			uint8_t _rx_sync;							//0 until the first valid frame was received
+			uint8_t _rx_error;							//1 after a corrupted frame was NACKed until the next valid frame
+			uint8_t _rx_held;							//Number of frames received out of order
+			uint8_t _rx_retries;						//Number of repeated NACKs for the current gap
+			uint32_t _rx_gap_time;						//Timestamp of the last NACK for the current gap
+			uint8_t _rx_hold[MUCOM_CRC_SLOTS][MUCOM_MAX_FRAME_LEN];	//Frames received out of order. First byte is 0 if unused
+			
+			//Check sequence number and CRC of a received frame
+			uint8_t _receiveChecked(const uint8_t *frame);
+			
+			//Execute all held frames following the next expected one
+			uint8_t _deliverHeld(void);
+			
+			//Request the retransmission of frames
+			void _sendNack(uint8_t seq, uint8_t num);
+			
+			//Retransmit frames requested by the communication partner
+			void _handleNack(uint8_t *data, uint8_t cnt);
+			
+			//Handle a corrupted or truncated frame
+			void _rxError(void);
+			
+			//Repeat NACKs or skip frames that got lost
+			uint8_t _processCrc(void);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_STATS
+			struct muCom_Stats_str *_stats;				//Statistics or NULL
+			
+			//Count a read request or write request of the communication partner
+			void _countAccess(uint16_t index);
+			
+			//Add the round-trip time of a read request to the histogram
+			void _countLatency(uint32_t latency);
+		#endif
+		
+		//Access to the HW functions of the derived class
+		inline Derived* _hw(void)
+			{	return static_cast<Derived*>(this);	}
+		
+		//Add a received byte to the frame being assembled
+		inline uint8_t _assemble(uint8_t data, uint8_t crc);
+		
+		//1 if a frame of which only the first "cnt" bytes are known might be a MUCOM_EXT_PAGE or MUCOM_EXT_OFFSET prefix
+		static uint8_t _mayBePrefix(const uint8_t *frame, uint8_t cnt);
+		
+		//Decode a chunk of received data
+		uint8_t _parse(const uint8_t *data, uint16_t cnt);
+		
+		//Frames were lost. The next frame might have lost its prefix and a received prefix might belong to a lost frame
+		inline void _rxLost(void)
+			{	this->_rx_skip = 1; this->_rx_page = 0; this->_rx_offset = 0;	}
+		
+		//Bytes were discarded on a plain link (MUCOM_RX_ERROR or MUCOM_RX_PREFIX). Only a lost prefix makes the next frame unusable
+		inline void _rxDiscarded(uint8_t res)
+			{	if(res == MUCOM_RX_PREFIX) { this->_rxLost(); } else { this->_rx_page = 0; this->_rx_offset = 0; }	}
+		
+		#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+			uint8_t _rxq_active;						//1 if received data is passed via receive() instead of being read by handle()
+			uint8_t _rxq_head;							//Number of frames queued. Only written by receive()
+			uint8_t _rxq_tail;							//Number of frames taken from the queue. Only written by handle()
+			uint8_t _rxq_error;							//1 if the newest queue entry is an error marker. Only used by receive()
+			uint8_t _rxq_lost;							//Result of data discarded on a plain link, queued in front of the next frame (0 = none). Only used by receive()
+			uint8_t _rxq[MUCOM_RXQ_SLOTS][MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];	//Received frames. First byte is 0 for a marker of discarded data, followed by the result
+			
+			//Execute all queued frames
+			uint8_t _processQueue(void);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+			uint8_t _tx_threshold;						//Number of collected bytes written to the HW at once (0 = frames are written immediately)
+			uint8_t _tx_cnt;							//Number of bytes in the transmit buffer
+			uint8_t _tx_buf[MUCOM_TXBUF_SIZE];			//Sent frames not written to the HW yet
+			
+			//Write the transmit buffer to the HW. Must be called while the interface is locked
+			void _flushBuffer(void);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+			uint8_t _txq_active;						//1 if sent frames are put into the transmit queue
+			uint16_t _txq_head;							//Number of bytes put into the queue (wraps)
+			uint16_t _txq_tail;							//Number of bytes written to the HW (wraps)
+			uint8_t _txq[MUCOM_TXQ_SIZE];				//Sent bytes not written to the HW yet
+			
+			//Write as many queued bytes to the HW as possible without blocking. Must be called while the interface is locked
+			void _drainTx(void);
+		#endif
+		
+		//Write encoded frames to the transmit queue or the HW. Must be called while the interface is locked
+		void _writeHw(uint8_t *data, uint8_t len);
+		
+		//1 if sent frames are put into the transmit queue
+		uint8_t _txQueueActive(void);
+		
+		//Number of bytes that can be sent without blocking. Writes queued bytes to the HW first. Must be called while the interface is locked
+		uint16_t _txSpace(void);
+		
+		//Write queued frames and notify the application about free space. Called by handle()
+		void _processTx(void);
+		
+		#ifndef MUCOM_DEACTIVATE_DISCOVERY
+			uint32_t _table_hash;						//Cached hash of the own table
+			uint8_t _table_hash_valid;					//0 if something was linked since the hash was calculated
+			struct muCom_Table_str *_table;				//Table of the communication partner being discovered or NULL
+			uint32_t _table_hash_rx;					//Hash received from the communication partner
+			uint32_t _table_time;						//Timestamp of the last table frame received
+			int8_t _table_status;						//MUCOM_PENDING while discovering or the result of the discovery
+			
+			int8_t _linkVariable(uint16_t index, uint8_t *var, uint16_t size, muCom_LinkedVariableType type);
+		#endif
+		
+		//Add, replace (var != NULL) or remove (var == NULL) an entry of the linked variables. "seq" is NULL unless it is double-buffered
+		int8_t _insertVar(uint16_t index, uint8_t *var, uint16_t size, volatile uint8_t *seq, muCom_LinkedVariableType type);
+		
+		#ifndef MUCOM_DEACTIVATE_BUFFERED
+			//Link both copies and the sequence counter of a double-buffered variable
+			int8_t _linkBuffered(uint16_t index, uint8_t *var, uint16_t size, volatile uint8_t *seq, muCom_LinkedVariableType type);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_DISCOVERY
+			
+			//Get the linked variables in ascending order of their indices, starting with pos = {0, 0}. NULL after the last one
+			const struct muCom_LinkedVariable_str* _nextVar(uint16_t *pos, struct muCom_LinkedVariable_str *buf);
+			
+			//Get the indices of the linked functions in ascending order, starting with pos = {0, 0}. 0 after the last one
+			uint8_t _nextFunc(uint16_t *pos, uint16_t *index);
+			
+			//Calculate the hash of the own table or return the cached one
+			uint32_t _tableHash(void);
+			
+			//Handle received discovery frames
+			void _handleDiscovery(uint8_t *data, uint8_t cnt);
+			
+			//Send a discovery request and wait for the answer
+			int8_t _discover(uint8_t mode);
+		#endif
+		
+		
+	public:
+		/**
+			\brief		Constructor of the core class
+			\param[in]	var_buf		Fixed buffer for linked variables
+			\param[in]	num_var		Max. number of variables to be linked
+			\param[in]	func_buf	Fixed buffer for linked functions
+			\param[in]	num_func	Max. number of functions to be linked
+			\details	The buffers only need one entry per linked variable or function, not one per index. The entries are kept sorted by their index,
+						so a variable is found directly if the indices start at 0 without gaps and by a binary search otherwise.
+						Interfaces only using constant tables (see linkTable()) may pass NULL and 0.
+		*/
+		muComCore(struct muCom_LinkedVariable_str *var_buf, uint16_t num_var, struct muCom_LinkedFunction_str *func_buf, uint16_t num_func);
+		
+		
+		/**
+			\brief	Get timestamp of last successful communication
+			\return	Timestamp
+		*/
+		inline uint32_t getLastCommTime(void)
+			{	return this->_lastCommTime;	}
+
+
+		/**
+			\brief		Set timeout for read requests
+			\param[in]	timeout	Timeout in milliseconds
+		*/
+		inline void setTimeout(int16_t timeout)
+			{	this->setTimeoutUs((timeout > 0) ? (uint32_t)timeout * 1000 : 0);	}
+		
+		
+		/**
+			\brief		Set timeout for read requests in microseconds
+			\details	With an adaptive timeout (see setAdaptiveTimeout()) this is the max. timeout.
+			\param[in]	timeout	Timeout in microseconds (min. MUCOM_MIN_TIMEOUT)
+		*/
+		void setTimeoutUs(uint32_t timeout);
+		
+		
+		/**
+			\brief		Activate or deactivate the adaptive timeout of read requests
+			\details	The interface tracks the smoothed round-trip time (SRTT) of read requests and its mean deviation (RTTVAR) like TCP does.
+						Read requests then time out after SRTT + 4 * RTTVAR (min. MUCOM_MIN_RTO, max. the timeout set via setTimeoutUs()),
+						so a lost response is detected after about one round-trip time. The adaptive timeout is doubled after each timeout.
+						Each request keeps the timeout of the time it was sent. Responses arriving after their request timed out are dropped
+						instead of completing a newer request of the same index, and never update the round-trip time (Karn's algorithm).
+						This also applies to the fixed timeout. A timed out request is remembered for the timeout set via setTimeoutUs().
+			\param[in]	enable	1 = adaptive timeout, 0 = fixed timeout (default)
+		*/
+		void setAdaptiveTimeout(uint8_t enable);
+		
+		
+		/**
+			\brief	Get the smoothed round-trip time of read requests
+			\return	Round-trip time in us (0 = no response received yet)
+		*/
+		inline uint32_t getRtt(void)
+			{	return this->_srtt;	}
+		
+		
+		/**
+			\brief	Get the current timeout of read requests
+			\return	Fixed or adaptive timeout in us
+		*/
+		inline uint32_t getTimeoutUs(void)
+			{	return this->_readTimeout();	}
+
+
+		/**
+			\brief		Handle the muCom interface
+			\details	This function handles the muCom interface and decodes the received data.
+						It should be executed as often as possible and will handle writing to and reading from linked variables
+						as well as executing requested functions. This function is also used during reading data from the communication partner.
+			\return		1 = answer for at least one read request was received, else 0
+		*/
+		uint8_t handle(void);
+		
+		
+		/**
+			\brief		Write all collected frames to the HW (see setTxCoalescing())
+			\details	Called by handle() and before waiting for the response of a blocking read request, so only frames sent
+						by asynchronous functions like write(), invokeFunction() or readAsync() outside of handle() may have to be flushed explicitly.
+						Does nothing without coalescing.
+		*/
+		void flush(void);
+		
+		#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+			/**
+				\brief		Collect sent frames and write them to the HW at once
+				\details	Usually every frame is written to the HW by a separate call of _write(), i.e. a system call per frame on hosts
+							and a USB packet per frame on USB CDC links. With coalescing the encoded frames are collected in a buffer of MUCOM_TX_BUFFER bytes
+							and written as soon as "threshold" bytes are collected, the next frame does not fit anymore, flush() or handle() is called
+							or a blocking read waits for its response. Frames sent in bursts, e.g. a set of parameters, thereby use the full bandwidth.
+				\param[in]	threshold	Number of collected bytes written at once (max. MUCOM_TX_BUFFER) or 0 to write every frame immediately (default)
+				\return		MUCOM_OK if all is alright, MUCOM_ERR if MUCOM_FEATURE_TX_COALESCING is not selected
+			*/
+			int8_t setTxCoalescing(uint8_t threshold);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+			/**
+				\brief		Activate or deactivate the transmit queue
+				\details	In this mode sent frames are put into a queue of MUCOM_TX_QUEUE bytes owned by the interface, which is written to the HW
+							as far as _availableTxBuffer() allows by every send function and by handle(). Functions like write() only wait while the queue
+							itself is full, tryWrite() never waits (see getTxQueueDepth() and setTxReadyCallback()).
+							Deactivating the queue waits until all queued frames are written to the HW.
+				\param[in]	enable	1 = use the transmit queue, 0 = write frames to the HW directly (default)
+				\return		MUCOM_OK if all is alright, MUCOM_ERR_TIMEOUT if the queue could not be written to the HW
+			*/
+			int8_t setTxQueue(uint8_t enable);
+			
+			/**
+				\brief	Get the number of bytes waiting in the transmit queue and the coalescing buffer
+				\return	Number of bytes not written to the HW yet
+			*/
+			uint16_t getTxQueueDepth(void);
+		#endif
+		
+		/**
+			\brief		Set the function notified when frames can be sent without blocking again
+			\details	After tryWrite() or tryInvokeFunction() returned MUCOM_ERR_BUSY, handle() calls the function once as soon as a frame
+						with page frame fits into the transmit queue or the transmit buffer of the HW.
+			\param[in]	function	Function to be called or NULL
+		*/
+		inline void setTxReadyCallback(muComTxReadyFunc function)
+			{	this->_tx_ready_func = function;	}
+		
+		#ifndef MUCOM_DEACTIVATE_CAPTURE
+			/**
+				\brief		Set the function receiving all data exchanged with the HW
+				\details	The function gets the raw bytes read from and written to the HW as well as every frame executed or sent
+							by the interface in decoded form, e.g. to record a trace for offline analysis (see muComTrace on hosts).
+							Received bytes are passed by the caller of handle() or receive(), sent ones while the interface is locked.
+				\param[in]	function	Function to be called or NULL
+				\param[in]	ctx			Context pointer passed to the function
+			*/
+			inline void setCapture(muComCaptureFunc function, void *ctx)
+				{	this->_capture_func = function; this->_capture_ctx = ctx;	}
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+			/**
+				\brief		Activate or deactivate the frame queue for received data
+				\details	In this mode handle() does not read from the HW anymore. Received data is passed via receive() from the RX interrupt
+							or a reader thread instead, which assembles the frames byte by byte and puts complete frames into a lock-free
+							single-producer/single-consumer queue of MUCOM_RX_QUEUE frames. handle() executes the queued frames at a safe point,
+							so the RX FIFO of the HW does not overflow during long main loop iterations.
+							Must be called while no data is passed via receive().
+				\param[in]	enable	1 = receive data via receive(), 0 = read data in handle() (default)
+				\return		MUCOM_OK if all is alright
+			*/
+			int8_t setRxQueue(uint8_t enable);
+			
+			/**
+				\brief		Pass received data to the interface
+				\details	To be called from a single producer only, e.g. the RX interrupt or a reader thread (see setRxQueue()).
+							If the queue is full, the frame is discarded and counted as discarded bytes. Producers able to wait, e.g. a reader thread,
+							should not pass more than rxQueueSpace() bytes at once.
+				\param[in]	data	Received data
+				\param[in]	cnt		Number of data bytes
+			*/
+			void receive(const uint8_t *data, uint16_t cnt);
+			
+			/**
+				\brief		Pass a single received byte to the interface, e.g. from the RX interrupt (see receive())
+				\param[in]	data	Received byte
+			*/
+			inline void receive(uint8_t data)
+				{	this->receive(&data, 1);	}
+			
+			/**
+				\brief	Get the number of received frames waiting to be executed by handle()
+				\return	Number of queued frames
+			*/
+			inline uint8_t queuedFrames(void)
+				{	return (uint8_t)(MUCOM_LOAD_ACQUIRE(this->_rxq_head) - this->_rxq_tail);	}
+			
+			/**
+				\brief		Get the number of bytes which can be passed to receive() without discarding a frame
+				\details	Every byte completes at most one frame, so this is the number of free entries of the queue.
+							To be called by the producer only.
+				\return		Number of bytes
+			*/
+			inline uint8_t rxQueueSpace(void)
+				{	return (uint8_t)(MUCOM_RXQ_SLOTS - (uint8_t)(this->_rxq_head - MUCOM_LOAD_ACQUIRE(this->_rxq_tail)));	}
+		#endif
+		
+		
+		/**
+			\brief		Link function to the muCom interface
+			\details	Any index except MUCOM_EXT_INDEX may be used as long as the buffer passed to the constructor has a free entry.
+						Linking NULL releases the entry of the index.
+			\param[in]	index		Index used to invoke this functions
+			\param[in]	function	Function to be linked to the interface
+			\return		MUCOM_OK if all is alright
+		*/
+		int8_t linkFunction(uint16_t index, muComFunc function);
+		
+		
+		#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+			/**
+				\brief		Link constant tables of variables and functions to the muCom interface
+				\details	The tables are read by handle() directly and may be located in flash (declared with MUCOM_PROGMEM), so they need no RAM
+							and nothing has to be linked at runtime. The buffers passed to the constructor are only needed for variables and functions
+							linked via linkVariable() and linkFunction() additionally, which take precedence over entries of the tables with the same index.
+							The entries are created with MUCOM_VAR(), MUCOM_BUFFERED_VAR() and MUCOM_FUNC() and must be sorted by index.
+							MUCOM_CHECK_TABLE() verifies this at compile time if the tables are declared as constexpr.
+				\param[in]	var			Table of linked variables or NULL
+				\param[in]	num_var		Number of entries of the table of linked variables
+				\param[in]	func		Table of linked functions or NULL
+				\param[in]	num_func	Number of entries of the table of linked functions
+				\return		MUCOM_OK if all is alright, MUCOM_ERR if a table is not sorted by index or a function uses MUCOM_EXT_INDEX
+			*/
+			int8_t linkTable(const struct muCom_LinkedVariable_str *var, uint16_t num_var, const struct muCom_LinkedFunction_str *func, uint16_t num_func);
+			
+			template<size_t NUM_VAR>
+			inline int8_t linkTable(const struct muCom_LinkedVariable_str (&var)[NUM_VAR])
+				{	return this->linkTable(var, NUM_VAR, NULL, 0);	}
+			
+			template<size_t NUM_VAR, size_t NUM_FUNC>
+			inline int8_t linkTable(const struct muCom_LinkedVariable_str (&var)[NUM_VAR], const struct muCom_LinkedFunction_str (&func)[NUM_FUNC])
+				{	return this->linkTable(var, NUM_VAR, func, NUM_FUNC);	}
+		#endif
+		
+		
+		/**
+			\brief		Link a variable or a buffer to the muCom interface
+			\details	Any index may be used as long as the buffer passed to the constructor has a free entry. Linking NULL releases the entry of the index.
+						Indices above 255 are accessed with two frames (see MUCOM_EXT_PAGE). Batch reads, bulk transfers and subscriptions only support indices up to 255.
+			\param[in]	index	Index used to access the variable/buffer
+			\param[in]	var		Pointer to the variable or buffer to be linked to the interface
+			\param[in]	size	Size of the variable/buffer in bytes (only neccessary when linking buffers)
+			\return		MUCOM_OK if all is alright
+		*/
+		#ifndef MUCOM_DEACTIVATE_DISCOVERY
+			inline int8_t linkVariable(uint16_t index, uint8_t *var, uint16_t size)
+				{	return this->_linkVariable(index, var, size, MUCOM_ARRAY);	}
+			
+			inline int8_t linkVariable(uint16_t index, uint8_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(uint8_t), MUCOM_UINT8);	}
+				
+			inline int8_t linkVariable(uint16_t index, int8_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(int8_t), MUCOM_INT8);	}
+			
+			inline int8_t linkVariable(uint16_t index, uint16_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(uint16_t), MUCOM_UINT16);	}
+			
+			inline int8_t linkVariable(uint16_t index, int16_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(int16_t), MUCOM_INT16);	}
+			
+			inline int8_t linkVariable(uint16_t index, uint32_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(uint32_t), MUCOM_UINT32);	}
+			
+			inline int8_t linkVariable(uint16_t index, int32_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(int32_t), MUCOM_INT32);	}
+			
+			inline int8_t linkVariable(uint16_t index, uint64_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(uint64_t), MUCOM_UINT64);	}
+			
+			inline int8_t linkVariable(uint16_t index, int64_t *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(int64_t), MUCOM_INT64);	}
+			
+			inline int8_t linkVariable(uint16_t index, float *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(float), MUCOM_FLOAT);	}
+				
+			inline int8_t linkVariable(uint16_t index, double *var)
+				{	return this->_linkVariable(index, (uint8_t*)var, sizeof(double), MUCOM_DOUBLE);	}
+		#else
+			int8_t linkVariable(uint16_t index, uint8_t *var, uint16_t size);
+			
+			inline int8_t linkVariable(uint16_t index, uint8_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(uint8_t));	}
+				
+			inline int8_t linkVariable(uint16_t index, int8_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(int8_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, uint16_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(uint16_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, int16_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(int16_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, uint32_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(uint32_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, int32_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(int32_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, uint64_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(uint64_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, int64_t *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(int64_t));	}
+			
+			inline int8_t linkVariable(uint16_t index, float *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(float));	}
+				
+			inline int8_t linkVariable(uint16_t index, double *var)
+				{	return this->linkVariable(index, (uint8_t*)var, sizeof(double));	}
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_BUFFERED
+			/**
+				\brief		Link a double-buffered variable to the muCom interface
+				\details	Read requests, batch reads and subscriptions get a consistent copy and write requests update the variable
+							without masking interrupts (see muComBuffered). Bulk transfers of such variables are rejected.
+				\param[in]	index	Index used to access the variable
+				\param[in]	var		Pointer to the double-buffered variable
+				\return		MUCOM_OK if all is alright
+			*/
+			template<typename T>
+			inline int8_t linkVariable(uint16_t index, muComBuffered<T> *var)
+				{	return this->_linkBuffered(index, (uint8_t*)var->buf, sizeof(T), &var->seq, muCom_typeOf((const T*)NULL));	}
+		#endif
+		
+		/**
+			\brief		Invoke a function at the communication partner
+			\param[in]	index	Index of the function to be invoked
+			\param[in]	data	Pointer to a buffer as a parameter for the function being invoked
+			\param[in]	cnt		Number of data bytes in the buffer that will be sent to the function being invoked
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t invokeFunction(uint16_t index, uint8_t* data, uint8_t cnt)
+			{	return this->writeRaw(MUCOM_EXECUTE_REQUEST, index, data, cnt);	}
+		
+		/**
+			\brief		Invoke a function at the communication partner
+			\details	The target function will be invoked with one byte of random data.
+			\param[in]	index	Index of the function to be invoked
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t invokeFunction(uint16_t index)
+			{	uint8_t dummy = 0; return this->writeRaw(MUCOM_EXECUTE_REQUEST, index, &dummy, 1);	}
+		
+
+		/**
+			\brief		Write a data array to a remote variable
+			\param[in]	index	Index of the remote buffer to be written to
+			\param[in]	data	Data array to be written to the remote buffer
+			\param[in]	cnt		Size of the data array in bytes
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t write(uint16_t index, uint8_t *data, uint8_t cnt)
+			{	return this->writeRaw(MUCOM_WRITE_REQUEST, index, data, cnt);	}
+		
+		/**
+			\brief		Write to a part of a linked buffer of the communication partner
+			\details	Only the given bytes are changed, so single elements of large linked arrays can be updated without
+						rewriting the array from the start. Requests with an offset are preceded by a MUCOM_EXT_OFFSET frame and are ignored
+						by the communication partner if the bytes are not inside the linked size. Double-buffered variables can only be written as a whole.
+			\param[in]	index	Index of the remote buffer to be written to
+			\param[in]	offset	Byte offset inside the remote buffer
+			\param[in]	data	Data array to be written to the remote buffer
+			\param[in]	cnt		Size of the data array in bytes (max. 8)
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeAt(uint16_t index, uint16_t offset, uint8_t *data, uint8_t cnt)
+			{	return this->_writeRaw(MUCOM_WRITE_REQUEST, index, offset, data, cnt);	}
+		
+		/**
+			\brief		Write a byte (8 bit) to the communication partner
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Byte to be written to the communication partner
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeByte(uint16_t index, uint8_t data)
+			{	return this->write(index, (uint8_t*)&data, sizeof(uint8_t));	}
+		
+		/**
+			\brief		Write a short (16 bit) to the communication partner
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Short to be written to the communication partner
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeShort(uint16_t index, uint16_t data)
+			{	return this->write(index, (uint8_t*)&data, sizeof(uint16_t));	}
+		
+		/**
+			\brief		Write a long (32 bit) to the communication partner
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Long to be written to the communication partner
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeLong(uint16_t index, uint32_t data)
+			{	return this->write(index, (uint8_t*)&data, sizeof(uint32_t));	}
+
+		/**
+			\brief		Write a long long (64 bit) to the communication partner
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Long long to be written to the communication partner
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeLongLong(uint16_t index, uint64_t data)
+			{	return this->write(index, (uint8_t*)&data, sizeof(uint64_t));	}
+		
+		/**
+			\brief		Write a float to the communication partner
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Float to be written to the communication partner
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeFloat(uint16_t index, float data)
+			{	return this->write(index, (uint8_t*)&data, sizeof(float));	}
+		
+		/**
+			\brief		Write a double to the communication partner (not available on AVR microcontrollers)
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Float to be written to the communication partner
+			\return		MUCOM_OK if the frame was sent, MUCOM_ERR_TIMEOUT if the transmit buffer stayed full (see tryWrite())
+		*/
+		inline int8_t writeDouble(uint16_t index, double data)
+			{	return this->write(index, (uint8_t*)&data, sizeof(double));	}
+		
+		/**
+			\brief		Write a data array to a remote variable without blocking
+			\details	write() waits for space in the transmit buffer of the HW and gives up after the timeout. tryWrite() only sends the frame if it fits
+						into the transmit queue (see setTxQueue()) or, without queue, into the transmit buffer of the HW right away. Otherwise nothing is sent
+						and the function set via setTxReadyCallback() is called by handle() as soon as a frame fits again, so control loops never stall.
+			\param[in]	index	Index of the remote buffer to be written to
+			\param[in]	data	Data array to be written to the remote buffer
+			\param[in]	cnt		Size of the data array in bytes
+			\return		MUCOM_OK if the frame was written to the HW
+						<br>MUCOM_QUEUED if the frame waits in the transmit queue or the coalescing buffer (see setTxCoalescing())
+						<br>MUCOM_ERR_BUSY if the frame was not sent
+						<br>MUCOM_ERR if the arguments are invalid
+		*/
+		inline int8_t tryWrite(uint16_t index, uint8_t *data, uint8_t cnt)
+			{	return this->_tryWriteRaw(MUCOM_WRITE_REQUEST, index, data, cnt);	}
+		
+		/**
+			\brief		Invoke a function at the communication partner without blocking (see tryWrite())
+			\param[in]	index	Index of the function to be invoked
+			\param[in]	data	Buffer with data to be sent to the function being invoked
+			\param[in]	cnt		Number of data bytes in the buffer that will be sent to the function being invoked
+			\return		See tryWrite()
+		*/
+		inline int8_t tryInvokeFunction(uint16_t index, uint8_t *data, uint8_t cnt)
+			{	return this->_tryWriteRaw(MUCOM_EXECUTE_REQUEST, index, data, cnt);	}
+			
+		/**
+			\brief		Send a read request without waiting for the response
+			\details	Up to MUCOM_MAX_PENDING_READS requests may be in flight at the same time, only one without MUCOM_FEATURE_PIPELINE.
+						Responses are decoded by handle() and matched to their requests by index in the order the requests were sent.
+						The data buffer must stay valid until readStatus() returned a final result or the request was cancelled.
+			\param[in]	index	Index of the remote variable to be read
+			\param[out]	data	Array to store the contents of the remote variable
+			\param[in]	cnt		Number of data bytes to read
+			\return		Tag of the request (>= 0) to be passed to readStatus()
+						<br>See muCom error codes in case of errors (< 0)
+		*/
+		inline int8_t readAsync(uint16_t index, uint8_t *data, uint8_t cnt)
+			{	return this->readAtAsync(index, 0, data, cnt);	}
+		
+		/**
+			\brief		Send a read request for a part of a linked buffer without waiting for the response (see readAsync())
+			\details	Requests with an offset are preceded by a MUCOM_EXT_OFFSET frame. Requests for bytes outside the linked size
+						are rejected by the communication partner and readStatus() returns MUCOM_ERR. Double-buffered variables can only be read as a whole.
+			\param[in]	index	Index of the remote buffer to be read
+			\param[in]	offset	Byte offset inside the remote buffer
+			\param[out]	data	Array to store the read bytes
+			\param[in]	cnt		Number of data bytes to read (max. 8)
+			\return		Tag of the request (>= 0) to be passed to readStatus()
+						<br>See muCom error codes in case of errors (< 0)
+		*/
+		int8_t readAtAsync(uint16_t index, uint16_t offset, uint8_t *data, uint8_t cnt);
+		
+		/**
+			\brief		Get the status of a read request sent via readAsync()
+			\details	Once a final result is returned the tag is released and must not be used anymore.
+			\param[in]	tag		Tag returned by readAsync()
+			\return		MUCOM_PENDING if the response was not received yet
+						<br>MUCOM_OK if the data was received
+						<br>See muCom error codes in case of errors (< 0)
+		*/
+		int8_t readStatus(uint8_t tag);
+		
+		/**
+			\brief		Cancel a read request sent via readAsync() and release its tag
+			\param[in]	tag		Tag returned by readAsync()
+		*/
+		void cancelRead(uint8_t tag);
+		
+		/**
+			\brief	Get the number of read requests waiting for their response
+			\return	Number of pending read requests
+		*/
+		uint8_t pendingReads(void);
+		
+		#ifndef MUCOM_DEACTIVATE_BULK
+			/**
+				\brief		Set the window used for bulk transfers initiated by this interface
+				\details	The window is the max. number of data frames sent before the receiver has to acknowledge them.
+							It should not exceed the number of frames the receive buffer of the slower partner can hold.
+				\param[in]	window	Number of unacknowledged data frames (1..127)
+			*/
+			void setBulkWindow(uint8_t window);
+			
+			/**
+				\brief		Read a part of a remote buffer of any size
+				\details	The communication partner streams the data with MUCOM_BULK_CHUNK bytes per frame.
+							Lost frames are detected by sequence numbers and retransmitted.
+				\param[in]	index	Index of the remote buffer to be read
+				\param[in]	offset	Offset of the first byte inside the remote buffer
+				\param[out]	data	Array to store the data
+				\param[in]	len		Number of data bytes to read
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			int8_t readBulk(uint8_t index, uint16_t offset, uint8_t *data, uint16_t len);
+			
+			/**
+				\brief		Write a part of a remote buffer of any size
+				\details	See readBulk()
+				\param[in]	index	Index of the remote buffer to be written to
+				\param[in]	offset	Offset of the first byte inside the remote buffer
+				\param[in]	data	Data to be written
+				\param[in]	len		Number of data bytes to write
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			int8_t writeBulk(uint8_t index, uint16_t offset, uint8_t *data, uint16_t len);
+		#endif
+		
+		/**
+			\brief		Set the function receiving variables pushed by the communication partner
+			\details	The function is called by handle() for every read response nobody was waiting for, e.g. due to a subscription.
+			\param[in]	function	Function to be called or NULL
+		*/
+		inline void setPushCallback(muComPushFunc function)
+			{	this->_push_func = function;	}
+		
+		#ifndef MUCOM_DEACTIVATE_DISCOVERY
+			/**
+				\brief		Read the hash of the table of linked variables and functions of the communication partner
+				\details	The hash changes whenever the partner links other variables or functions, so a table stored by the host
+							can be reused as long as the hash matches (see muComPosix::discoverCached()).
+				\param[out]	hash	Hash of the table
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			int8_t readTableHash(uint32_t *hash);
+			
+			/**
+				\brief		Read the table of linked variables and functions of the communication partner
+				\details	The partner answers with one frame per linked variable, one frame per 7 linked functions and its hash in a single burst.
+				\param[out]	table	Table of the communication partner
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			int8_t discover(struct muCom_Table_str *table);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_CRC
+			/**
+				\brief		Activate or deactivate checksummed frames
+				\details	In this mode every frame is followed by a sequence number and a CRC-7. Corrupted or missing frames are NACKed by the receiver
+							immediately and only these frames are retransmitted from the last MUCOM_CRC_FRAMES sent frames, so a disturbed read is answered
+							after about one frame time instead of failing with a timeout. Frames are executed in the order they were sent.
+							Both communication partners have to use the same setting.
+				\param[in]	enable	1 = use checksummed frames, 0 = use plain frames (default)
+				\return		MUCOM_OK if all is alright
+			*/
+			int8_t setCrc(uint8_t enable);
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_STATS
+			/**
+				\brief		Link a structure collecting statistics of the link
+				\details	The structure is cleared and updated by the interface from then on. The communication partner can read it via readStats().
+				\param[in]	stats	Statistics or NULL to stop collecting them
+			*/
+			void linkStats(struct muCom_Stats_str *stats);
+			
+			#ifndef MUCOM_DEACTIVATE_BULK
+				/**
+					\brief		Read the statistics of the communication partner
+					\details	The statistics are read with a bulk transfer from the reserved index MUCOM_EXT_INDEX.
+								Both partners have to use the same MUCOM_STATS_INDICES. The counters are not read as a consistent snapshot.
+					\param[out]	stats	Structure to store the statistics
+					\return		See muCom error codes (0 = OK, <0 = Error, e.g. if the partner did not link any statistics)
+				*/
+				inline int8_t readStats(struct muCom_Stats_str *stats)
+					{	return this->readBulk(MUCOM_EXT_INDEX, 0, (uint8_t*)stats, sizeof(struct muCom_Stats_str));	}
+			#endif
+		#endif
+		
+		#ifndef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+			/**
+				\brief		Subscribe to a remote variable
+				\details	The communication partner pushes the variable with its linked size (max. 8 bytes) without further read requests.
+							The values are passed to the function set via setPushCallback(). The first value is pushed immediately.
+				\param[in]	index	Index of the remote variable
+				\param[in]	period	Push period in ms (MUCOM_SUBSCRIBE_PERIODIC, min. MUCOM_MIN_SUB_PERIOD of the communication partner)
+									or min. time between two pushes (MUCOM_SUBSCRIBE_ON_CHANGE, 0 = every change)
+				\param[in]	mode	MUCOM_SUBSCRIBE_PERIODIC or MUCOM_SUBSCRIBE_ON_CHANGE
+			*/
+			void subscribe(uint8_t index, uint16_t period, uint8_t mode);
+			
+			/**
+				\brief		Cancel the subscription of a remote variable
+				\param[in]	index	Index of the remote variable or MUCOM_EXT_INDEX to cancel all subscriptions
+			*/
+			void unsubscribe(uint8_t index);
+			
+			/**
+				\brief		Link a buffer for the deadbands of the linked variables
+				\details	Variables subscribed by the communication partner with MUCOM_SUBSCRIBE_ON_CHANGE are always compared to the value
+							of their last push. With an entry in this buffer they are only pushed if they changed by more than their deadband (see setDeadband()).
+				\param[in]	buf		Buffer with one entry per linked variable, starting at index 0
+				\param[in]	num		Number of entries of the buffer
+			*/
+			void linkPublishBuffer(struct muCom_PublishedVariable_str *buf, uint8_t num);
+			
+			/**
+				\brief		Set the deadband of a linked variable
+				\details	Changes of the variable smaller than or equal to the deadband do not trigger a push (see linkPublishBuffer()).
+							Deadbands are supported for all numeric variable types, buffers are pushed on any change.
+							They require the types of the linked variables, which are not stored with MUCOM_DEACTIVATE_DISCOVERY.
+				\param[in]	index		Index of the linked variable
+				\param[in]	deadband	Absolute difference or fraction of the last pushed value (e.g. 0.01 = 1%)
+				\param[in]	mode		MUCOM_DEADBAND_ABSOLUTE or MUCOM_DEADBAND_RELATIVE
+				\return		MUCOM_OK if all is alright, MUCOM_ERR if the index has no entry in the buffer or deadbands
+							are not supported (MUCOM_DEACTIVATE_DISCOVERY)
+			*/
+			int8_t setDeadband(uint8_t index, float deadband, uint8_t mode);
+		#endif
+		
+		/**
+			\brief		Send a batch read request for several variables without waiting for the responses
+			\details	The communication partner copies all variables under a single lock and answers with one response frame per variable,
+						so the values represent a consistent snapshot. The size of each variable must match the size it was linked with by the partner.
+						Consecutive indices are requested with a range request, others with a list request (max. MUCOM_EXT_MAX_ARGS indices).
+			\param[in]	index	Array of indices of the remote variables to be read
+			\param[out]	data	Array of buffers to store the contents of the remote variables
+			\param[in]	cnt		Array with the number of data bytes of each variable
+			\param[in]	num		Number of variables to read (max. MUCOM_MAX_BATCH_READ)
+			\param[out]	tags	Array receiving one tag per variable to be passed to readStatus()
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		int8_t readBatchAsync(const uint8_t *index, uint8_t * const *data, const uint8_t *cnt, uint8_t num, int8_t *tags);
+		
+		/**
+			\brief		Read a consistent snapshot of several variables from the communication partner
+			\details	See readBatchAsync()
+			\param[in]	index	Array of indices of the remote variables to be read
+			\param[out]	data	Array of buffers to store the contents of the remote variables
+			\param[in]	cnt		Array with the number of data bytes of each variable
+			\param[in]	num		Number of variables to read (max. MUCOM_MAX_BATCH_READ)
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		int8_t readBatch(const uint8_t *index, uint8_t * const *data, const uint8_t *cnt, uint8_t num);
+		
+		/**
+			\brief		Read data from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Array to store the contents of the remote variable
+			\param[in]	cnt		Number of data bytes to read
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t read(uint16_t index, uint8_t *data, uint8_t cnt)
+			{	return this->readAt(index, 0, data, cnt);	}
+		
+		/**
+			\brief		Read a part of a linked buffer from the communication partner (see readAtAsync())
+			\param[in]	index	Index of the remote buffer to be read
+			\param[in]	offset	Byte offset inside the remote buffer
+			\param[out]	data	Array to store the read bytes
+			\param[in]	cnt		Number of data bytes to read (max. 8)
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		int8_t readAt(uint16_t index, uint16_t offset, uint8_t *data, uint8_t cnt);
+		
+		/**
+			\brief		Read a byte from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Pointer to the variable where the read data should be stored
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t readByte(uint16_t index, uint8_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(uint8_t));	}
+		
+		inline int8_t readByte(uint16_t index, int8_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(int8_t));	}
+		
+		/**
+			\brief		Read a short from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Pointer to the variable where the read data should be stored
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t readShort(uint16_t index, uint16_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(uint16_t));	}
+		
+		inline int8_t readShort(uint16_t index, int16_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(int16_t));	}
+		
+		/**
+			\brief		Read a long from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Pointer to the variable where the read data should be stored
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t readLong(uint16_t index, uint32_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(uint32_t));	}
+		
+		inline int8_t readLong(uint16_t index, int32_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(int32_t));	}
+		
+		/**
+			\brief		Read a long long from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Pointer to the variable where the read data should be stored
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t readLongLong(uint16_t index, uint64_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(uint64_t));	}
+		
+		inline int8_t readLongLong(uint16_t index, int64_t *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(int64_t));	}
+		
+		/**
+			\brief		Read a float from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Pointer to the variable where the read data should be stored
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t readFloat(uint16_t index, float *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(float));	}
+		
+		/**
+			\brief		Read a double from the communication partner (not available on AVR microcontrollers)
+			\param[in]	index	Index of the remote variable to be read
+			\param[in]	data	Pointer to the variable where the read data should be stored
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		inline int8_t readDouble(uint16_t index, double *data)
+			{	return this->read(index, (uint8_t*)data, sizeof(float));	}
+			
+		/**
+			\brief		Read a byte from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\return		Byte read from the communication partner.
+						<br>-1 in case of errors
+		*/
+		uint8_t readByte(uint16_t index);
+		
+		/**
+			\brief		Read a short from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\return		Short read from the communication partner.
+						<br>-1 in case of errors
+		*/
+		uint16_t readShort(uint16_t index);
+		
+		/**
+			\brief		Read a long from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\return		Long read from the communication partner.
+						<br>-1 in case of errors
+		*/
+		uint32_t readLong(uint16_t index);
+		
+		/**
+			\brief		Read a long long from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\return		Long long read from the communication partner.
+						<br>-1 in case of errors
+		*/
+		uint64_t readLongLong(uint16_t index);
+		
+		/**
+			\brief		Read a float from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\return		Float read from the communication partner.
+						<br>-1 in case of errors
+		*/
+		float readFloat(uint16_t index);
+		
+		/**
+			\brief		Read a float from the communication partner
+			\param[in]	index	Index of the remote variable to be read
+			\return		Float read from the communication partner.
+						<br>-1 in case of errors
+		*/
+		double readDouble(uint16_t index);
+		
+		#ifndef MUCOM_DEACTIVATE_RMW
+			/**
+				\brief		Send a read-modify-write request without waiting for the response
+				\details	The communication partner applies the operation to the linked integer variable with interrupts masked
+							and answers with the previous value, so a remote counter or flag register is changed with a single round trip
+							and without losing concurrent updates of the partner. The response is handed over like the one of readAsync().
+							Compare-and-swap requests are preceded by a MUCOM_EXT_RMW_ARG frame with the compare value.
+							Invalid requests, e.g. for an unlinked index or a size exceeding the linked one, are rejected by the partner
+							and readStatus() returns MUCOM_ERR without waiting for the timeout.
+				\param[in]	index	Index of the remote variable (max. 255)
+				\param[in]	op		Operation (MUCOM_RMW_...), optionally combined with MUCOM_RMW_SIGNED
+				\param[in]	operand	Operand of the operation (size bytes)
+				\param[in]	compare	Compare value of MUCOM_RMW_CAS (size bytes), ignored otherwise
+				\param[out]	prev	Buffer receiving the previous value of the remote variable (size bytes)
+				\param[in]	size	Size of the remote variable in bytes (1, 2 or 4)
+				\return		Tag to be passed to readStatus() or muCom error code (<0 = Error)
+			*/
+			int8_t modifyAsync(uint8_t index, uint8_t op, const uint8_t *operand, const uint8_t *compare, uint8_t *prev, uint8_t size);
+			
+			/**
+				\brief		Modify a remote variable atomically and get its previous value (see modifyAsync())
+				\param[in]	index	Index of the remote variable (max. 255)
+				\param[in]	op		Operation (MUCOM_RMW_...), optionally combined with MUCOM_RMW_SIGNED
+				\param[in]	operand	Operand of the operation (size bytes)
+				\param[in]	compare	Compare value of MUCOM_RMW_CAS (size bytes), ignored otherwise
+				\param[out]	prev	Buffer receiving the previous value of the remote variable (size bytes)
+				\param[in]	size	Size of the remote variable in bytes (1, 2 or 4)
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			int8_t modify(uint8_t index, uint8_t op, const uint8_t *operand, const uint8_t *compare, uint8_t *prev, uint8_t size);
+			
+			/**
+				\brief		Add a value to a remote integer variable
+				\param[in]	index	Index of the remote variable
+				\param[in]	value	Value to be added (wraps around)
+				\param[out]	prev	Previous value of the remote variable
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t fetchAdd(uint8_t index, T value, T *prev)
+				{	return this->modify(index, MUCOM_RMW_ADD, (uint8_t*)&value, NULL, (uint8_t*)prev, sizeof(T));	}
+			
+			/**
+				\brief		Replace a remote integer variable if it still holds the expected value
+				\param[in]	index		Index of the remote variable
+				\param[in]	expected	Value the remote variable must hold
+				\param[in]	desired		New value of the remote variable
+				\param[out]	prev		Previous value of the remote variable. The variable was replaced if it equals "expected"
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t compareAndSwap(uint8_t index, T expected, T desired, T *prev)
+				{	return this->modify(index, MUCOM_RMW_CAS, (uint8_t*)&desired, (uint8_t*)&expected, (uint8_t*)prev, sizeof(T));	}
+			
+			/**
+				\brief		Set bits of a remote integer variable
+				\param[in]	index	Index of the remote variable
+				\param[in]	mask	Bits to be set
+				\param[out]	prev	Previous value of the remote variable
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t setBits(uint8_t index, T mask, T *prev)
+				{	return this->modify(index, MUCOM_RMW_SET, (uint8_t*)&mask, NULL, (uint8_t*)prev, sizeof(T));	}
+			
+			/**
+				\brief		Clear bits of a remote integer variable
+				\param[in]	index	Index of the remote variable
+				\param[in]	mask	Bits to be cleared
+				\param[out]	prev	Previous value of the remote variable
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t clearBits(uint8_t index, T mask, T *prev)
+				{	return this->modify(index, MUCOM_RMW_CLEAR, (uint8_t*)&mask, NULL, (uint8_t*)prev, sizeof(T));	}
+			
+			/**
+				\brief		Toggle bits of a remote integer variable
+				\param[in]	index	Index of the remote variable
+				\param[in]	mask	Bits to be toggled
+				\param[out]	prev	Previous value of the remote variable
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t toggleBits(uint8_t index, T mask, T *prev)
+				{	return this->modify(index, MUCOM_RMW_TOGGLE, (uint8_t*)&mask, NULL, (uint8_t*)prev, sizeof(T));	}
+			
+			/**
+				\brief		Limit a remote integer variable to a maximum value
+				\param[in]	index	Index of the remote variable
+				\param[in]	limit	Upper limit. Signed types are compared as signed values
+				\param[out]	prev	Previous value of the remote variable
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t fetchMin(uint8_t index, T limit, T *prev)
+				{	return this->modify(index, MUCOM_RMW_MIN | (((T)-1 < (T)0) ? MUCOM_RMW_SIGNED : 0), (uint8_t*)&limit, NULL, (uint8_t*)prev, sizeof(T));	}
+			
+			/**
+				\brief		Limit a remote integer variable to a minimum value
+				\param[in]	index	Index of the remote variable
+				\param[in]	limit	Lower limit. Signed types are compared as signed values
+				\param[out]	prev	Previous value of the remote variable
+				\return		See muCom error codes (0 = OK, <0 = Error)
+			*/
+			template<typename T>
+			inline int8_t fetchMax(uint8_t index, T limit, T *prev)
+				{	return this->modify(index, MUCOM_RMW_MAX | (((T)-1 < (T)0) ? MUCOM_RMW_SIGNED : 0), (uint8_t*)&limit, NULL, (uint8_t*)prev, sizeof(T));	}
+		#endif
+};
+
+
+
+//Implementation of the class template
+#include "muComCoreImpl.h"
+
+
+#endif //MUCOMCORE_H
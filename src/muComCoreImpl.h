@@ -0,0 +1,3925 @@
+/**
+	\brief		Implementation of the muCom core class template
+	\details	This file is included by muComCore.h and must not be included directly.
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMCOREIMPL_H
+#define MUCOMCOREIMPL_H
+
+#include "muComCodec.h"
+#include <string.h>
+
+//Shorthands for the definitions of the member functions
+#define MUCOM_CORE_TEMPLATE		template<class Derived, uint16_t FEATURES>
+#define MUCOM_CORE				muComCore<Derived, FEATURES>
+
+//Update the statistics if they are collected
+#ifndef MUCOM_DEACTIVATE_STATS
+	#define MUCOM_STATS(stmt)		do { if((FEATURES & MUCOM_FEATURE_STATS) && (this->_stats != NULL)) { this->_stats->stmt; } } while(0)
+#else
+	#define MUCOM_STATS(stmt)		do { } while(0)
+#endif
+
+//Pass data to the capture function if one is set
+#ifndef MUCOM_DEACTIVATE_CAPTURE
+	#define MUCOM_CAPTURE(type, data, cnt)	do { if(this->_capture_func != NULL) { this->_capture_func(this->_capture_ctx, type, data, cnt); } } while(0)
+#else
+	#define MUCOM_CAPTURE(type, data, cnt)	do { } while(0)
+#endif
+
+/*
+##### Frame structure #####
+Byte	Bit(s)	Function
+0		7		Start of frame indicator (must be '1')
+0		6-5		Frame description
+					0	read data response
+					1	read data request
+					2	write data request
+					3	Execute function request
+0		4-2		Data byte count -1 (relevant for read and write frames)
+0		1-0		Bits 6-7 of 1. payload byte	
+1		7		Start of frame indicator (must be '0')
+1		6-1		Bits 5-0 of 1. payload byte 
+1		0		Bit 7 of 2. payload byte
+2		7		Start of frame indicator (must be '0')
+2		6-0		Bits 6-0 of 2. payload byte
+3		7		Start of frame indicator (must be '0')
+3		6-0		Bits 7-1 of 3. payload byte
+4		7		Start of frame indicator (must be '0')
+4		6		Bit 0 of 3. payload byte
+4		5-0		Bits 7-2 of 4. payload byte
+5		7		Start of frame indicator (must be '0')
+5		6-5		Bits 1-0 of 4. payload byte
+5		4-0		Bits 7-3 of 5. payload byte
+6		7		Start of frame indicator (must be '0')
+6		6-4		Bits 2-0 of 5. payload byte
+6		3-0		Bits 7-4 of 6. payload byte
+7		7		Start of frame indicator (must be '0')
+7		6-3		Bits 3-0 of 6. payload byte
+7		2-0		Bits 7-5 of 7. payload byte
+8		7		Start of frame indicator (must be '0')
+8		6-2		Bits 4-0 of 7. payload byte
+8		1-0		Bits 7-6 of 8. payload byte
+9		7		Start of frame indicator (must be '0')
+9		6-1		Bits 5-0 of 8. payload byte
+9		0		Bit 7 of 9. payload byte
+10		7		Start of frame indicator (must be '0')
+10		6-0		Bits 6-0 of 9. payload byte
+
+The first payload byte is the variable/function index, the following ones are the data bytes.
+
+
+##### Extended frames #####
+Execute requests to the index MUCOM_EXT_INDEX (0xFF) are extended frames. This index can never be linked.
+The first data byte is the opcode, the remaining data bytes (max. 7) are its arguments.
+
+Opcode					Arguments						Function
+MUCOM_EXT_READ_LIST		Index 1..7						Read a consistent snapshot of the listed variables
+MUCOM_EXT_READ_RANGE	First index, number				Read a consistent snapshot of consecutive variables
+MUCOM_EXT_BULK_READ		Index, offset, length, window	Start streaming a part of a linked buffer to the requester
+MUCOM_EXT_BULK_WRITE	Index, offset, length, window	Start receiving a part of a linked buffer from the requester
+MUCOM_EXT_BULK_DATA		Sequence number, data 1..6		Chunk of a bulk transfer
+MUCOM_EXT_BULK_ACK		Sequence number, retransmit		Next chunk expected by the receiver of a bulk transfer
+MUCOM_EXT_BULK_ABORT	Direction						Abort the bulk transfer received (0) or sent (1) by the recipient
+MUCOM_EXT_SUBSCRIBE		Index, period, mode				Push a linked variable periodically or on change with read response frames
+MUCOM_EXT_UNSUBSCRIBE	Index							Stop pushing a linked variable (MUCOM_EXT_INDEX = all variables)
+MUCOM_EXT_NACK			First sequence number, number	Retransmit frames of checksummed mode
+MUCOM_EXT_DISCOVER		Mode							Send the hash (MUCOM_DISCOVER_HASH) or the whole table (MUCOM_DISCOVER_TABLE)
+MUCOM_EXT_TABLE_VAR		Index, size, type, upper index	Linked variable of the sender (answer to MUCOM_EXT_DISCOVER)
+MUCOM_EXT_TABLE_FUNC	Index 1..7						Linked functions of the sender (answer to MUCOM_EXT_DISCOVER)
+MUCOM_EXT_TABLE_HASH	Hash, variables, functions		Hash (32 bit) and size of the table of the sender. Always the last frame of a discovery
+MUCOM_EXT_PAGE			Upper index						Upper byte of the index of the next frame
+MUCOM_EXT_TABLE_FUNC_PAGE	Upper index, index 1..6		Linked functions with indices above 255 (answer to MUCOM_EXT_DISCOVER)
+MUCOM_EXT_RMW			Index, operation, operand 1..4	Modify a linked integer variable atomically and answer with its previous value
+MUCOM_EXT_RMW_ARG		Index, compare value 1..4		Compare value of the next MUCOM_EXT_RMW frame of the same index (MUCOM_RMW_CAS)
+MUCOM_EXT_OFFSET		Offset, upper index				Byte offset (16 bit) and upper index byte of the next read or write request
+MUCOM_EXT_RMW_REJECT	Index							Read-modify-write request of the index was rejected (answer to MUCOM_EXT_RMW)
+MUCOM_EXT_READ_REJECT	Index, upper index				Read request of the index was rejected (answer to a read request)
+
+Batch reads are answered with one read response frame per linked variable (data byte count = linked size, max. 8).
+16 and 32 bit values (offset, length, size, hash) are transmitted with the low byte first.
+The table hash is a FNV-1a hash of index, size and type of all linked variables and the indices of all linked functions.
+
+Bulk transfers split the data into chunks of MUCOM_BULK_CHUNK bytes. The sender transmits up to "window" chunks before it has to wait
+for an acknowledge. The receiver acknowledges every half window and when the last chunk was received.
+A gap in the sequence numbers makes the receiver request a retransmission starting at the first missing chunk.
+Both sides retry after a timeout without progress and abort the transfer after MUCOM_BULK_RETRIES retries.
+A bulk read of the index MUCOM_EXT_INDEX returns the statistics of the interface (see linkStats()).
+
+A read-modify-write request is answered with a read response frame holding the previous value (data byte count = operand size).
+The operand size (1, 2 or 4 bytes) must not exceed the linked size. Values are transmitted in the byte order of the sender like write requests.
+Requests with an unknown operation, an unlinked index, an operand larger than the linked size or a missing compare value are answered with a
+MUCOM_EXT_RMW_REJECT frame instead, which completes the oldest read-modify-write request of the index with MUCOM_ERR. Read requests
+of the index waiting for their response are not affected.
+
+Read, write and execute requests and read responses for indices above 255 are preceded by a MUCOM_EXT_PAGE frame. The index of the frame
+itself holds the lower byte. The upper byte only applies to the next frame. A prefix and the frame it belongs to are executed together or not at all:
+The first frame after a corrupted frame or after frames skipped in checksummed mode is discarded, unless it is a prefix itself.
+Without checksummed frames this only applies after a truncated or dropped frame which might have been a prefix, i.e. an execute request to
+MUCOM_EXT_INDEX. Other discarded data just resets the upper index byte. A MUCOM_EXT_PAGE frame lost completely, e.g. with a corrupted header,
+makes the next frame access the index of its lower byte.
+Read and write requests accessing a linked buffer at a byte offset are preceded by a MUCOM_EXT_OFFSET frame instead, which holds the upper
+index byte as well and is handled like a MUCOM_EXT_PAGE prefix after lost frames. Read requests for bytes outside the linked size are answered
+with a MUCOM_EXT_READ_REJECT frame, which completes the oldest plain read request of the index with MUCOM_ERR. Such write requests are ignored.
+Read requests for unlinked indices are not answered.
+
+
+##### Checksummed frames #####
+If activated via setCrc() every frame is followed by two more bytes (start of frame indicator '0'):
+Byte	Bit(s)	Function
+n		6-0		Sequence number of the frame (incremented for every frame sent, wraps at 128)
+n+1		6-0		CRC-7 (x^7 + x^3 + 1) of all preceding bytes of the frame including the sequence number
+
+The sender keeps the last MUCOM_CRC_FRAMES frames. The receiver executes the frames in the order of their sequence numbers.
+A frame with a wrong CRC, a truncated frame or a gap in the sequence numbers is answered with a MUCOM_EXT_NACK frame immediately,
+the sender retransmits only the requested frames. Frames received after a gap are held until the gap is filled.
+Missing frames are NACKed again up to MUCOM_CRC_RETRIES times and skipped afterwards, so the timeout of a read request is never exceeded.
+The first frame after skipped ones is discarded as well, unless it is a prefix frame (see above).
+*/
+
+
+
+
+MUCOM_CORE_TEMPLATE
+MUCOM_CORE::muComCore(struct muCom_LinkedVariable_str *var_buf, uint16_t num_var, struct muCom_LinkedFunction_str *func_buf, uint16_t num_func)
+{
+	//Reset receive statemachine
+	this->_rcv_buf_cnt = 0;
+	this->_rx_page = 0;
+	this->_rx_offset = 0;
+	this->_rx_skip = 0;
+	
+	//Link buffer for linked variables. Entries are initialized when they are linked
+	this->_linked_var_num = num_var;
+	this->_linked_var_cnt = 0;
+	this->_linked_var = var_buf;
+	
+	//Link buffer for linked functions
+	this->_linked_func_num = num_func;
+	this->_linked_func_cnt = 0;
+	this->_linked_func = func_buf;
+	
+	#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+		//No constant tables until linkTable() is called
+		this->_const_var = NULL;
+		this->_const_var_cnt = 0;
+		this->_const_func = NULL;
+		this->_const_func_cnt = 0;
+	#endif
+	
+	//Setup default timeout
+	this->_timeout = MUCOM_DEFAULT_TIMEOUT * 1000UL;
+	this->_srtt = 0;
+	this->_rttvar = 0;
+	this->_rto = this->_timeout;
+	this->_adaptive = 0;
+	
+	//Reset pending read requests
+	memset(this->_pending, 0, sizeof(this->_pending));
+	this->_pending_order = 0;
+	memset(this->_late, 0, sizeof(this->_late));
+	
+	#ifndef MUCOM_DEACTIVATE_BULK
+		//Reset bulk transfers
+		memset(&this->_bulk_tx, 0, sizeof(this->_bulk_tx));
+		memset(&this->_bulk_rx, 0, sizeof(this->_bulk_rx));
+		this->_bulk_window = MUCOM_BULK_WINDOW;
+	#endif
+	
+	this->_push_func = NULL;
+	this->_tx_ready_func = NULL;
+	this->_tx_busy = 0;
+	
+	#ifndef MUCOM_DEACTIVATE_CAPTURE
+		//Nothing is captured until setCapture() is called
+		this->_capture_func = NULL;
+		this->_capture_ctx = NULL;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_RMW
+		//No compare value received yet
+		this->_rmw_arg_cnt = 0;
+		this->_rmw_arg_index = 0;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+		//Reset subscriptions
+		memset(this->_subs, 0, sizeof(this->_subs));
+		this->_published = NULL;
+		this->_published_num = 0;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_CRC
+		//Plain frames until setCrc() is called
+		this->_crc = 0;
+		this->_tx_seq = 0;
+		this->_rx_next = 0;
+		this->_rx_high = 0;
+		this->_rx_sync = 0;
+		this->_rx_error = 0;
+		this->_rx_held = 0;
+		this->_rx_retries = 0;
+		this->_rx_gap_time = 0;
+		memset(this->_tx_ring, 0, sizeof(this->_tx_ring));
+		memset(this->_rx_hold, 0, sizeof(this->_rx_hold));
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_STATS
+		this->_stats = NULL;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		this->_table_hash_valid = 0;
+		this->_table = NULL;
+		this->_table_status = MUCOM_OK;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+		//Frames are written immediately until setTxCoalescing() is called
+		this->_tx_threshold = 0;
+		this->_tx_cnt = 0;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+		//Frames are written to the HW directly until setTxQueue() is called
+		this->_txq_active = 0;
+		this->_txq_head = 0;
+		this->_txq_tail = 0;
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+		//Data is read by handle() until setRxQueue() is called
+		this->_rxq_active = 0;
+		this->_rxq_head = 0;
+		this->_rxq_tail = 0;
+		this->_rxq_error = 0;
+		this->_rxq_lost = 0;
+	#endif
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::setTimeoutUs(uint32_t timeout)
+{
+	if(timeout < MUCOM_MIN_TIMEOUT) //Limit timeout to minimum value
+	{
+		timeout = MUCOM_MIN_TIMEOUT;
+	}
+	this->_timeout = timeout;
+	if(this->_rto > timeout)
+	{
+		this->_rto = timeout;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::setAdaptiveTimeout(uint8_t enable)
+{
+	this->_adaptive = (enable != 0) ? 1 : 0;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_addLate(uint8_t tag)
+{
+	struct muCom_LateRead_str *late = &this->_late[0];
+	uint8_t i;
+	
+	//Use a free entry or replace the oldest one
+	for(i = 0; i < MUCOM_PENDING_SLOTS; i++)
+	{
+		if(this->_late[i].used == 0)
+		{
+			late = &this->_late[i];
+			break;
+		}
+		if((uint8_t)(this->_pending_order - this->_late[i].order) > (uint8_t)(this->_pending_order - late->order))
+		{
+			late = &this->_late[i];
+		}
+	}
+	
+	late->time_out = this->_hw()->_getTimestampUs();
+	late->index = this->_pending[tag].index;
+	late->order = this->_pending[tag].order;
+	late->reject = this->_pending[tag].reject;
+	late->used = 1;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_updateRtt(uint32_t rtt)
+{
+	uint32_t diff;
+	
+	//RTO estimation according to RFC 6298 with alpha = 1/8 and beta = 1/4
+	if(this->_srtt == 0)
+	{
+		this->_srtt = (rtt != 0) ? rtt : 1;
+		this->_rttvar = rtt / 2;
+	}
+	else
+	{
+		diff = (rtt > this->_srtt) ? (rtt - this->_srtt) : (this->_srtt - rtt);
+		this->_rttvar = (3 * this->_rttvar + diff) / 4;
+		this->_srtt = (7 * this->_srtt + rtt) / 8;
+		if(this->_srtt == 0)
+		{
+			this->_srtt = 1;
+		}
+	}
+	
+	this->_rto = this->_srtt + 4 * this->_rttvar;
+	if(this->_rto < MUCOM_MIN_RTO)
+	{
+		this->_rto = MUCOM_MIN_RTO;
+	}
+	if(this->_rto > this->_timeout)
+	{
+		this->_rto = this->_timeout;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::handle(void)
+{
+	uint8_t buf[MUCOM_RX_CHUNK];
+	uint16_t cnt;
+	uint8_t ret = 0;
+	
+	#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+		if((FEATURES & MUCOM_FEATURE_RX_QUEUE) && this->_rxq_active)
+		{
+			//Frames were already assembled by receive()
+			ret |= this->_processQueue();
+		}
+		else
+	#endif
+	{
+		//Read all available data in chunks
+		while((cnt = this->_hw()->_readBuffer(buf, sizeof(buf))) != 0)
+		{
+			MUCOM_CAPTURE(MUCOM_CAPTURE_RX, buf, cnt);
+			ret |= this->_parse(buf, cnt);
+		}
+	}
+	
+	#ifndef MUCOM_DEACTIVATE_CRC
+		if((FEATURES & MUCOM_FEATURE_CRC) && this->_crc)
+		{
+			ret |= this->_processCrc();
+		}
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_BULK
+		if(FEATURES & MUCOM_FEATURE_BULK)
+		{
+			this->_processBulk();
+		}
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+		if(FEATURES & MUCOM_FEATURE_SUBSCRIPTIONS)
+		{
+			this->_processSubscriptions();
+		}
+	#endif
+	
+	//Answers and pushed values of this call are written at once
+	this->flush();
+	this->_processTx();
+	
+	return ret;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+inline uint8_t MUCOM_CORE::_assemble(uint8_t data, uint8_t crc)
+{
+	uint8_t len, res;
+	
+	if(data & MUCOM_HEADER_BIT_MASK)
+	{
+		//Header received! Reset receive statemachine, e.g. data counter
+		len = this->_rcv_buf_cnt;
+		res = MUCOM_RX_NONE;
+		if(len != 0)
+		{
+			//Previous frame is truncated
+			MUCOM_STATS(bytes_discarded += len);
+			res = _mayBePrefix(this->_rcv_buf, len) ? MUCOM_RX_PREFIX : MUCOM_RX_ERROR;
+		}
+		
+		this->_rcv_buf_cnt = 1;
+		this->_rcv_buf[0] = data;
+		return res;
+	}
+	
+	if(this->_rcv_buf_cnt == 0)
+	{
+		//Waiting for the header... Discard any non-header bytes, e.g. the remainder of a frame with a corrupted header
+		MUCOM_STATS(bytes_discarded++);
+		return MUCOM_RX_ERROR;
+	}
+	
+	//Store data byte and increase byte counter
+	this->_rcv_buf[this->_rcv_buf_cnt] = data;
+	this->_rcv_buf_cnt++;
+	
+	//Calculate desired frame length
+	len = muCom_getFrameLength(this->_rcv_buf[0]);
+	if(crc)
+	{
+		len += MUCOM_CRC_LEN;
+	}
+	
+	if(this->_rcv_buf_cnt >= len)
+	{
+		//Sufficient data received
+		this->_rcv_buf_cnt = 0; //Reset statemachine
+		return MUCOM_RX_FRAME;
+	}
+	
+	return MUCOM_RX_NONE;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_mayBePrefix(const uint8_t *frame, uint8_t cnt)
+{
+	uint8_t opcode;
+	
+	//The header holds the frame type and the upper 2 bits of the index, the first data byte the remaining 6 bits of the index
+	//and the upper bit of the opcode, the second data byte the remaining 7 bits of the opcode (see muCom_encodeFrame())
+	if((frame[0] & (MUCOM_FRAME_DESC_MASK | 0x03)) != (MUCOM_EXECUTE_REQUEST | (MUCOM_EXT_INDEX >> 6)))
+	{
+		return 0;
+	}
+	if((cnt >= 2) && ((frame[1] & 0x7E) != ((MUCOM_EXT_INDEX << 1) & 0x7E)))
+	{
+		return 0;
+	}
+	if(cnt < 3)
+	{
+		return 1;
+	}
+	
+	opcode = ((frame[1] & 0x01) << 7) | (frame[2] & 0x7F);
+	return ((opcode == MUCOM_EXT_PAGE) || (opcode == MUCOM_EXT_OFFSET)) ? 1 : 0;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_parse(const uint8_t *data, uint16_t cnt)
+{
+	uint8_t ret = 0;
+	uint8_t crc = 0;
+	uint8_t res;
+	
+	#ifndef MUCOM_DEACTIVATE_CRC
+		crc = (FEATURES & MUCOM_FEATURE_CRC) ? this->_crc : 0;
+	#endif
+	
+	//Process all received data bytes
+	while(cnt != 0)
+	{
+		cnt--;
+		res = this->_assemble(*data++, crc);
+		switch(res)
+		{
+			case MUCOM_RX_FRAME:
+				//Decode the frame and do stuff if required
+				#ifndef MUCOM_DEACTIVATE_CRC
+					if(crc)
+					{
+						ret |= this->_receiveChecked(this->_rcv_buf);
+						break;
+					}
+				#endif
+				ret |= this->_dispatch(this->_rcv_buf);
+				break;
+			
+			case MUCOM_RX_ERROR:
+			case MUCOM_RX_PREFIX:
+				#ifndef MUCOM_DEACTIVATE_CRC
+					if(crc)
+					{
+						this->_rxError();
+						break;
+					}
+				#endif
+				this->_rxDiscarded(res);
+				break;
+			
+			default:
+				break;
+		}
+	}
+	
+	return ret;
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::setRxQueue(uint8_t enable)
+{
+	if(((FEATURES & MUCOM_FEATURE_RX_QUEUE) == 0) && (enable != 0))
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_hw()->_disableInterrupts();
+	this->_rxq_active = (enable != 0) ? 1 : 0;
+	this->_rxq_head = 0;
+	this->_rxq_tail = 0;
+	this->_rxq_error = 0;
+	this->_rxq_lost = 0;
+	this->_rcv_buf_cnt = 0;
+	this->_hw()->_enableInterrupts();
+	
+	return MUCOM_OK;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::receive(const uint8_t *data, uint16_t cnt)
+{
+	uint8_t head, len;
+	uint8_t crc = 0;
+	uint8_t res;
+	
+	if(((FEATURES & MUCOM_FEATURE_RX_QUEUE) == 0) || (this->_rxq_active == 0))
+	{
+		return;
+	}
+	
+	MUCOM_CAPTURE(MUCOM_CAPTURE_RX, data, cnt);
+	
+	#ifndef MUCOM_DEACTIVATE_CRC
+		crc = (FEATURES & MUCOM_FEATURE_CRC) ? this->_crc : 0;
+	#endif
+	
+	head = this->_rxq_head; //Only written here
+	while(cnt != 0)
+	{
+		cnt--;
+		res = this->_assemble(*data++, crc);
+		if(res == MUCOM_RX_NONE)
+		{
+			continue;
+		}
+		
+		//Errors are handled in order with the frames by a marker entry. Checksummed links get one per run of corrupted data.
+		//Plain links only need to know the worst result in front of the next frame (see _rxDiscarded()), so it is merged
+		if(res != MUCOM_RX_FRAME)
+		{
+			if(crc == 0)
+			{
+				this->_rxq_lost = (res > this->_rxq_lost) ? res : this->_rxq_lost;
+				continue;
+			}
+			if(this->_rxq_error != 0)
+			{
+				continue;
+			}
+		}
+		
+		if((uint8_t)(head - MUCOM_LOAD_ACQUIRE(this->_rxq_tail)) >= (MUCOM_RXQ_SLOTS - ((this->_rxq_lost != 0) ? 1 : 0)))
+		{
+			//Queue full. The frame is lost. Checksummed links notice this by the sequence number, plain links the same way as corrupted data
+			if(res == MUCOM_RX_FRAME)
+			{
+				len = muCom_getFrameLength(this->_rcv_buf[0]);
+				MUCOM_STATS(bytes_discarded += len + (crc ? MUCOM_CRC_LEN : 0));
+				if(crc == 0)
+				{
+					//A prefix lost before belonged to this frame
+					this->_rxq_lost = _mayBePrefix(this->_rcv_buf, len) ? MUCOM_RX_PREFIX : MUCOM_RX_ERROR;
+				}
+			}
+			continue;
+		}
+		
+		if(this->_rxq_lost != 0)
+		{
+			this->_rxq[head % MUCOM_RXQ_SLOTS][0] = 0;
+			this->_rxq[head % MUCOM_RXQ_SLOTS][1] = this->_rxq_lost;
+			this->_rxq_lost = 0;
+			head++;
+		}
+		
+		if(res == MUCOM_RX_FRAME)
+		{
+			len = muCom_getFrameLength(this->_rcv_buf[0]) + (crc ? MUCOM_CRC_LEN : 0);
+			memcpy(this->_rxq[head % MUCOM_RXQ_SLOTS], this->_rcv_buf, len);
+			this->_rxq_error = 0;
+		}
+		else
+		{
+			this->_rxq[head % MUCOM_RXQ_SLOTS][0] = 0;
+			this->_rxq[head % MUCOM_RXQ_SLOTS][1] = res;
+			this->_rxq_error = 1;
+		}
+		
+		//Publish the entries to handle()
+		head++;
+		MUCOM_STORE_RELEASE(this->_rxq_head, head);
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_processQueue(void)
+{
+	uint8_t frame[MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];
+	uint8_t tail;
+	uint8_t ret = 0;
+	
+	while((tail = this->_rxq_tail) != MUCOM_LOAD_ACQUIRE(this->_rxq_head))
+	{
+		//Copy the entry and release it right away, so the producer may reuse it while the frame is executed.
+		//This also keeps the queue consistent if a linked function calls handle() again
+		memcpy(frame, this->_rxq[tail % MUCOM_RXQ_SLOTS], sizeof(frame));
+		MUCOM_STORE_RELEASE(this->_rxq_tail, (uint8_t)(tail + 1));
+		
+		#ifndef MUCOM_DEACTIVATE_CRC
+			if((FEATURES & MUCOM_FEATURE_CRC) && this->_crc)
+			{
+				if(frame[0] == 0)
+				{
+					this->_rxError();
+				}
+				else
+				{
+					ret |= this->_receiveChecked(frame);
+				}
+				continue;
+			}
+		#endif
+		
+		if(frame[0] != 0)
+		{
+			ret |= this->_dispatch(frame);
+		}
+		else
+		{
+			this->_rxDiscarded(frame[1]);
+		}
+	}
+	
+	return ret;
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_dispatch(const uint8_t *frame)
+{
+	uint8_t payload[MUCOM_MAX_PAYLOAD_LEN];
+	uint8_t value[MUCOM_MAX_PAYLOAD_LEN - 1];
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	muComFunc func;
+	uint8_t ret = 0;
+	uint8_t dataCnt, frameDesc;
+	uint16_t index, offset;
+	
+	#ifndef MUCOM_DEACTIVATE_CAPTURE
+		if(this->_capture_func != NULL)
+		{
+			this->_captureFrame(MUCOM_CAPTURE_FRAME_RX, frame);
+		}
+	#endif
+	
+	//Decode frame type and data count
+	frameDesc = frame[0] & MUCOM_FRAME_DESC_MASK;
+	dataCnt = ((frame[0] & MUCOM_DATA_BYTE_CNT_MASK) >> 2) + 1;
+	
+	//Reconstruct data from frame
+	//payload[0] = Index, payload[1..8] = Data bytes
+	muCom_decodeFrame(frame, payload);
+	
+	//A preceding MUCOM_EXT_PAGE or MUCOM_EXT_OFFSET frame holds the upper byte of the index and the byte offset. It is only valid for a single frame
+	index = payload[0] | ((uint16_t)this->_rx_page << 8);
+	offset = this->_rx_offset;
+	this->_rx_page = 0;
+	this->_rx_offset = 0;
+	
+	//Frames were lost in front of this one. A prefix and the frame it belongs to are executed together or not at all,
+	//so the frame is discarded unless it is a prefix itself
+	if(this->_rx_skip != 0)
+	{
+		this->_rx_skip = 0;
+		if((frameDesc != MUCOM_EXECUTE_REQUEST) || (index != MUCOM_EXT_INDEX) || ((payload[1] != MUCOM_EXT_PAGE) && (payload[1] != MUCOM_EXT_OFFSET)))
+		{
+			MUCOM_STATS(bytes_discarded += muCom_getFrameLength(frame[0]));
+			return 0;
+		}
+	}
+	
+	this->_lastCommTime = this->_hw()->_getTimestamp();//Save timestamp
+	MUCOM_STATS(frames_received++);
+	
+	
+	//Execute command
+	switch(frameDesc)
+	{
+		case MUCOM_READ_RESPONSE:
+			//Hand data over to the read request waiting for it
+			ret |= this->_completeRead(index, payload + 1, dataCnt, 0);
+			break;
+			
+		case MUCOM_READ_REQUEST:
+			//Check index, whether a variable is linked and whether the read bytes are inside the linked variable
+			var = this->_findVarAt(index, offset, dataCnt, &entry);
+			if(var != NULL)
+			{
+				#ifndef MUCOM_DEACTIVATE_STATS
+					this->_countAccess(index);
+				#endif
+				this->_loadVar(var, value, dataCnt, 0);
+				this->writeRaw(MUCOM_READ_RESPONSE, index, value, dataCnt);
+			}
+			else if(this->_findVar(index, &entry) != NULL)
+			{
+				//Otherwise the requester would take the response of its next read of the index
+				this->_rejectRead(index);
+			}
+			break;
+			
+		case MUCOM_WRITE_REQUEST:
+			//Check index, whether a variable is linked and whether the written bytes are inside the linked variable
+			var = this->_findVarAt(index, offset, dataCnt, &entry);
+			if(var != NULL)
+			{
+				#ifndef MUCOM_DEACTIVATE_STATS
+					this->_countAccess(index);
+				#endif
+				this->_storeVar(var, payload + 1, dataCnt, 1);
+			}
+			break;
+			
+		case MUCOM_EXECUTE_REQUEST:
+			if(index == MUCOM_EXT_INDEX)
+			{
+				this->_handleExtended(payload + 1, dataCnt);
+				break;
+			}
+			//Check index and whether a function is linked
+			func = this->_findFunc(index);
+			if(func != NULL)
+			{
+				func((uint8_t*)(payload + 1), dataCnt);
+			}
+			break;
+			
+		default:
+			//Error! Ignore frame
+			break;
+	}
+	
+	return ret;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+const struct muCom_LinkedVariable_str* MUCOM_CORE::_findVarAt(uint16_t index, uint16_t offset, uint8_t cnt, struct muCom_LinkedVariable_str *buf)
+{
+	const struct muCom_LinkedVariable_str *var = this->_findVar(index, buf);
+	
+	if((var == NULL) || (((uint32_t)offset + cnt) > var->size))
+	{
+		return NULL;
+	}
+	
+	if(offset != 0)
+	{
+		#ifndef MUCOM_DEACTIVATE_BUFFERED
+			if(var->seq != NULL)
+			{
+				return NULL; //Double-buffered variables are only accessed as a whole
+			}
+		#endif
+		
+		//Copy of the entry starting at the offset
+		if(var != buf)
+		{
+			*buf = *var;
+		}
+		buf->addr = (uint8_t*)buf->addr + offset;
+		buf->size -= offset;
+		var = buf;
+	}
+	
+	return var;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_loadVar(const struct muCom_LinkedVariable_str *var, uint8_t *data, uint8_t cnt, uint8_t lock)
+{
+	#ifndef MUCOM_DEACTIVATE_BUFFERED
+		uint8_t seq;
+		
+		if(var->seq != NULL)
+		{
+			//Copy the valid copy again if the writer updated the variable in the meantime
+			do
+			{
+				seq = MUCOM_LOAD_ACQUIRE(*var->seq);
+				memcpy(data, (uint8_t*)var->addr + (seq & 1) * var->size, cnt);
+				MUCOM_FENCE();
+			} while(seq != *var->seq);
+			return;
+		}
+	#endif
+	
+	if(lock)
+	{
+		this->_hw()->_disableInterrupts();
+	}
+	memcpy(data, var->addr, cnt);
+	if(lock)
+	{
+		this->_hw()->_enableInterrupts();
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_storeVar(const struct muCom_LinkedVariable_str *var, const uint8_t *data, uint8_t cnt, uint8_t lock)
+{
+	#ifndef MUCOM_DEACTIVATE_BUFFERED
+		uint8_t seq;
+		uint8_t *dst;
+		
+		if(var->seq != NULL)
+		{
+			//Write to the other copy and make it the valid one afterwards. The interface is the only writer
+			seq = *var->seq;
+			dst = (uint8_t*)var->addr + ((seq + 1) & 1) * var->size;
+			MUCOM_FENCE();
+			if(cnt < var->size)
+			{
+				memcpy(dst, (uint8_t*)var->addr + (seq & 1) * var->size, var->size); //Keep the bytes not being written
+			}
+			memcpy(dst, data, cnt);
+			MUCOM_STORE_RELEASE(*var->seq, (uint8_t)(seq + 1));
+			return;
+		}
+	#endif
+	
+	if(lock)
+	{
+		this->_hw()->_disableInterrupts();
+	}
+	memcpy(var->addr, data, cnt);
+	if(lock)
+	{
+		this->_hw()->_enableInterrupts();
+	}
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_CRC
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_receiveChecked(const uint8_t *frame)
+{
+	uint8_t payload[MUCOM_MAX_PAYLOAD_LEN];
+	uint8_t len = muCom_getFrameLength(frame[0]);
+	uint8_t seq = frame[len];
+	uint8_t diff, ret = 0;
+	
+	if(muCom_crc7(frame, len + 1) != frame[len + 1])
+	{
+		MUCOM_STATS(comm_errors++);
+		this->_rxError();
+		return 0;
+	}
+	this->_rx_error = 0;
+	
+	//NACKs refer to frames sent by this interface. Retransmit them right away, even if frames before the NACK are missing
+	if(((frame[0] & MUCOM_FRAME_DESC_MASK) == MUCOM_EXECUTE_REQUEST) && (len >= 5))
+	{
+		muCom_decodeFrame(frame, payload);
+		if((payload[0] == MUCOM_EXT_INDEX) && (payload[1] == MUCOM_EXT_NACK))
+		{
+			this->_handleNack(payload + 1, ((frame[0] & MUCOM_DATA_BYTE_CNT_MASK) >> 2) + 1);
+		}
+	}
+	
+	diff = (seq - this->_rx_next) & 0x7F;
+	if((this->_rx_sync == 0) || ((diff >= MUCOM_CRC_SLOTS) && (diff < (128 - 2 * MUCOM_CRC_SLOTS))))
+	{
+		//First frame or too many frames lost. Synchronize to the sender
+		if(diff != 0)
+		{
+			this->_rxLost();
+		}
+		this->_rx_sync = 1;
+		this->_rx_next = seq;
+		this->_rx_high = seq;
+		this->_rx_held = 0;
+		memset(this->_rx_hold, 0, sizeof(this->_rx_hold));
+		diff = 0;
+	}
+	
+	if(diff == 0)
+	{
+		//Expected frame. Execute it together with all held frames following it
+		ret = this->_dispatch(frame);
+		this->_rx_next = (this->_rx_next + 1) & 0x7F;
+		ret |= this->_deliverHeld();
+	}
+	else if(diff < MUCOM_CRC_SLOTS)
+	{
+		//Frame received after a gap. Hold it until the missing frames are retransmitted
+		if(this->_rx_hold[seq % MUCOM_CRC_SLOTS][0] == 0)
+		{
+			memcpy(this->_rx_hold[seq % MUCOM_CRC_SLOTS], frame, len);
+			this->_rx_held++;
+		}
+		
+		//Request all frames missing since the newest frame received so far
+		len = (this->_rx_high - this->_rx_next) & 0x7F;
+		if(diff >= len)
+		{
+			if(len == 0)
+			{
+				//New gap
+				this->_rx_retries = 0;
+				this->_rx_gap_time = this->_hw()->_getTimestampUs();
+			}
+			if(diff > len)
+			{
+				this->_sendNack(this->_rx_high, diff - len);
+			}
+			this->_rx_high = (seq + 1) & 0x7F;
+		}
+	}
+	//Else: Frame was already received. The NACK probably crossed the frame
+	
+	return ret;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_deliverHeld(void)
+{
+	uint8_t *frame;
+	uint8_t ret = 0;
+	
+	while(this->_rx_held != 0)
+	{
+		frame = this->_rx_hold[this->_rx_next % MUCOM_CRC_SLOTS];
+		if(frame[0] == 0)
+		{
+			break; //Still a gap in front of the held frames
+		}
+		
+		ret |= this->_dispatch(frame);
+		frame[0] = 0;
+		this->_rx_held--;
+		this->_rx_next = (this->_rx_next + 1) & 0x7F;
+	}
+	
+	//The newest frame might have been executed
+	if(((this->_rx_high - this->_rx_next) & 0x7F) > MUCOM_CRC_SLOTS)
+	{
+		this->_rx_high = this->_rx_next;
+	}
+	
+	if(this->_rx_high != this->_rx_next)
+	{
+		//Progress was made, but frames are still missing
+		this->_rx_retries = 0;
+		this->_rx_gap_time = this->_hw()->_getTimestampUs();
+	}
+	
+	return ret;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_sendNack(uint8_t seq, uint8_t num)
+{
+	uint8_t buf[3];
+	
+	buf[0] = MUCOM_EXT_NACK;
+	buf[1] = seq;
+	buf[2] = num;
+	
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 3);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_handleNack(uint8_t *data, uint8_t cnt)
+{
+	uint8_t *frame;
+	uint8_t seq, age, len, i;
+	
+	if((cnt < 3) || (this->_lockTx() != MUCOM_OK))
+	{
+		return;
+	}
+	
+	for(i = 0; (i < data[2]) && (i < MUCOM_CRC_SLOTS); i++)
+	{
+		//Only frames already sent and still stored can be retransmitted
+		seq = (data[1] + i) & 0x7F;
+		age = (this->_tx_seq - seq) & 0x7F;
+		if((age == 0) || (age > MUCOM_CRC_SLOTS))
+		{
+			continue;
+		}
+		
+		frame = this->_tx_ring[seq % MUCOM_CRC_SLOTS];
+		len = muCom_getFrameLength(frame[0]) + MUCOM_CRC_LEN;
+		if(frame[len - 2] == seq)
+		{
+			this->_output(frame, len);
+			MUCOM_STATS(frames_sent++);
+			MUCOM_STATS(retransmits++);
+		}
+	}
+	
+	this->_unlockTx();
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_rxError(void)
+{
+	//Only NACK once per disturbance. The corrupted frame most likely was the next new one
+	if(this->_rx_error != 0)
+	{
+		return;
+	}
+	this->_rx_error = 1;
+	
+	this->_sendNack(this->_rx_high, 1);
+	if(this->_rx_high == this->_rx_next)
+	{
+		//New gap
+		this->_rx_retries = 0;
+		this->_rx_gap_time = this->_hw()->_getTimestampUs();
+	}
+	if(((this->_rx_high - this->_rx_next) & 0x7F) < (MUCOM_CRC_SLOTS - 1))
+	{
+		this->_rx_high = (this->_rx_high + 1) & 0x7F;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_processCrc(void)
+{
+	uint32_t interval;
+	uint8_t num;
+	
+	//Ask again after a round-trip time, so the missing frames are skipped before read requests time out
+	interval = this->_adaptive ? this->_rto : (this->_timeout / (MUCOM_CRC_RETRIES + 1));
+	if((this->_rx_high == this->_rx_next) || ((uint32_t)(this->_hw()->_getTimestampUs() - this->_rx_gap_time) < interval))
+	{
+		return 0;
+	}
+	this->_rx_gap_time = this->_hw()->_getTimestampUs();
+	
+	//Count the missing frames in front of the first held frame
+	for(num = 0; ((this->_rx_next + num) & 0x7F) != this->_rx_high; num++)
+	{
+		if(this->_rx_hold[(this->_rx_next + num) % MUCOM_CRC_SLOTS][0] != 0)
+		{
+			break;
+		}
+	}
+	
+	if(this->_rx_retries < MUCOM_CRC_RETRIES)
+	{
+		//The retransmission got lost as well. Ask again
+		this->_rx_retries++;
+		this->_sendNack(this->_rx_next, num);
+		return 0;
+	}
+	
+	//Give up on the missing frames and execute the held ones, if any
+	this->_rx_next = (this->_rx_next + num) & 0x7F;
+	this->_rxLost();
+	return this->_deliverHeld();
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::setCrc(uint8_t enable)
+{
+	if(((FEATURES & MUCOM_FEATURE_CRC) == 0) && (enable != 0))
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_hw()->_disableInterrupts();
+	this->_crc = (enable != 0) ? 1 : 0;
+	this->_tx_seq = 0;
+	this->_rx_next = 0;
+	this->_rx_high = 0;
+	this->_rx_sync = 0;
+	this->_rx_error = 0;
+	this->_rx_held = 0;
+	this->_rx_skip = 0;
+	memset(this->_tx_ring, 0, sizeof(this->_tx_ring));
+	memset(this->_rx_hold, 0, sizeof(this->_rx_hold));
+	this->_rcv_buf_cnt = 0;
+	this->_hw()->_enableInterrupts();
+	
+	return MUCOM_OK;
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_completeRead(uint16_t index, uint8_t *data, uint8_t cnt, uint8_t reject)
+{
+	struct muCom_PendingRead_str *req = NULL;
+	struct muCom_LateRead_str *late;
+	uint8_t i, age, max_age = 0, late_age = 0;
+	uint32_t now, rtt;
+	
+	this->_hw()->_disableInterrupts();
+	
+	//Find oldest pending request for this index, as the partner answers requests in the order they were received
+	for(i = 0; i < MUCOM_PENDING_SLOTS; i++)
+	{
+		if((this->_pending[i].data != NULL) && (this->_pending[i].status == MUCOM_PENDING) && (this->_pending[i].index == index)
+			&& ((reject == 0) || (this->_pending[i].reject == reject)))
+		{
+			age = this->_pending_order - this->_pending[i].order;
+			if((req == NULL) || (age > max_age))
+			{
+				req = &this->_pending[i];
+				max_age = age;
+			}
+		}
+	}
+	
+	//Requests of the index which timed out before are answered first. Drop the late response, so it neither completes
+	//a newer request with stale data nor yields a too short round-trip time
+	now = this->_hw()->_getTimestampUs();
+	late = NULL;
+	for(i = 0; i < MUCOM_PENDING_SLOTS; i++)
+	{
+		if((this->_late[i].used != 0) && (this->_late[i].index == index) && ((reject == 0) || (this->_late[i].reject == reject)))
+		{
+			if((uint32_t)(now - this->_late[i].time_out) >= this->_timeout)
+			{
+				this->_late[i].used = 0; //The response got lost
+				continue;
+			}
+			age = this->_pending_order - this->_late[i].order;
+			if(((req == NULL) || (age > max_age)) && ((late == NULL) || (age > late_age)))
+			{
+				late = &this->_late[i];
+				late_age = age;
+			}
+		}
+	}
+	if(late != NULL)
+	{
+		late->used = 0;
+		if(req != NULL)
+		{
+			//If the response of the timed out request got lost, this was the response of the waiting one
+			req->ambiguous = 1;
+		}
+		this->_hw()->_enableInterrupts();
+		return 0;
+	}
+	
+	if(req == NULL)
+	{
+		//Nobody is waiting for this response, e.g. a subscribed variable was pushed
+		this->_hw()->_enableInterrupts();
+		if((this->_push_func != NULL) && (index <= 0xFF) && (reject == 0))
+		{
+			this->_push_func(index, data, cnt);
+		}
+		return 0;
+	}
+	
+	if(reject != 0)
+	{
+		req->status = MUCOM_ERR; //Rejected by the communication partner
+	}
+	else if(req->size != cnt)
+	{
+		req->status = MUCOM_ERR_COMM;
+		MUCOM_STATS(comm_errors++);
+	}
+	else
+	{
+		memcpy(req->data, data, cnt);
+		req->status = MUCOM_OK;
+		
+		rtt = now - req->time_start;
+		this->_updateRtt(rtt);
+		#ifndef MUCOM_DEACTIVATE_STATS
+			this->_countLatency(rtt);
+		#endif
+	}
+	
+	this->_hw()->_enableInterrupts();
+	
+	return 1;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_handleExtended(uint8_t *data, uint8_t cnt)
+{
+	uint8_t index[MUCOM_MAX_BATCH_READ];
+	uint8_t i;
+	
+	switch(data[0])
+	{
+		case MUCOM_EXT_READ_LIST:
+			this->_sendSnapshot(data + 1, cnt - 1);
+			break;
+			
+		case MUCOM_EXT_READ_RANGE:
+			if((cnt < 3) || (data[2] > MUCOM_MAX_BATCH_READ))
+			{
+				break;
+			}
+			for(i = 0; i < data[2]; i++)
+			{
+				index[i] = data[1] + i;
+			}
+			this->_sendSnapshot(index, data[2]);
+			break;
+			
+		#ifndef MUCOM_DEACTIVATE_BULK
+			case MUCOM_EXT_BULK_READ:
+			case MUCOM_EXT_BULK_WRITE:
+			case MUCOM_EXT_BULK_DATA:
+			case MUCOM_EXT_BULK_ACK:
+			case MUCOM_EXT_BULK_ABORT:
+				if(FEATURES & MUCOM_FEATURE_BULK)
+				{
+					this->_handleBulk(data, cnt);
+				}
+				break;
+		#endif
+			
+		case MUCOM_EXT_NACK:
+			//Already handled when the frame was received
+			break;
+			
+		case MUCOM_EXT_READ_REJECT:
+			if(cnt >= 3)
+			{
+				this->_completeRead(data[1] | ((uint16_t)data[2] << 8), NULL, 0, MUCOM_EXT_READ_REJECT);
+			}
+			break;
+			
+		case MUCOM_EXT_PAGE:
+			if(cnt >= 2)
+			{
+				this->_rx_page = data[1];
+			}
+			break;
+			
+		case MUCOM_EXT_OFFSET:
+			if(cnt >= 4)
+			{
+				this->_rx_offset = data[1] | ((uint16_t)data[2] << 8);
+				this->_rx_page = data[3];
+			}
+			break;
+			
+		#ifndef MUCOM_DEACTIVATE_DISCOVERY
+			case MUCOM_EXT_DISCOVER:
+			case MUCOM_EXT_TABLE_VAR:
+			case MUCOM_EXT_TABLE_FUNC:
+			case MUCOM_EXT_TABLE_FUNC_PAGE:
+			case MUCOM_EXT_TABLE_HASH:
+				if(FEATURES & MUCOM_FEATURE_DISCOVERY)
+				{
+					this->_handleDiscovery(data, cnt);
+				}
+				break;
+		#endif
+			
+		#ifndef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+			case MUCOM_EXT_SUBSCRIBE:
+			case MUCOM_EXT_UNSUBSCRIBE:
+				if(FEATURES & MUCOM_FEATURE_SUBSCRIPTIONS)
+				{
+					this->_handleSubscription(data, cnt);
+				}
+				break;
+		#endif
+			
+		#ifndef MUCOM_DEACTIVATE_RMW
+			case MUCOM_EXT_RMW:
+			case MUCOM_EXT_RMW_ARG:
+				this->_handleRmw(data, cnt);
+				break;
+				
+			case MUCOM_EXT_RMW_REJECT:
+				if(cnt >= 2)
+				{
+					this->_completeRead(data[1], NULL, 0, MUCOM_EXT_RMW_REJECT);
+				}
+				break;
+		#endif
+			
+		default:
+			//Unknown opcode. Ignore frame
+			break;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_rejectRead(uint16_t index)
+{
+	uint8_t buf[3];
+	
+	buf[0] = MUCOM_EXT_READ_REJECT;
+	buf[1] = (uint8_t)index;
+	buf[2] = (uint8_t)(index >> 8);
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 3);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_sendSnapshot(uint8_t *index, uint8_t num)
+{
+	uint8_t snapshot[MUCOM_MAX_BATCH_READ][8];
+	uint8_t size[MUCOM_MAX_BATCH_READ];
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	uint8_t i;
+	
+	if(num > MUCOM_MAX_BATCH_READ)
+	{
+		num = MUCOM_MAX_BATCH_READ;
+	}
+	
+	//Copy all variables at once so the communication partner gets a consistent state
+	this->_hw()->_disableInterrupts();
+	for(i = 0; i < num; i++)
+	{
+		size[i] = 0;
+		var = this->_findVar(index[i], &entry);
+		if(var != NULL)
+		{
+			size[i] = (var->size > 8) ? 8 : var->size;
+			this->_loadVar(var, snapshot[i], size[i], 0);
+			#ifndef MUCOM_DEACTIVATE_STATS
+				this->_countAccess(index[i]);
+			#endif
+		}
+	}
+	this->_hw()->_enableInterrupts();
+	
+	//Send one response per linked variable
+	for(i = 0; i < num; i++)
+	{
+		if(size[i] != 0)
+		{
+			this->writeRaw(MUCOM_READ_RESPONSE, index[i], snapshot[i], size[i]);
+		}
+	}
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_RMW
+//Integer of 1, 2 or 4 bytes in the byte order of the MCU. Sign-extended if "sign" is set
+static inline uint32_t muCom_loadInt(const uint8_t *data, uint8_t size, uint8_t sign)
+{
+	uint8_t u8;
+	uint16_t u16;
+	uint32_t u32;
+	
+	switch(size)
+	{
+		case 1:
+			u8 = data[0];
+			return sign ? (uint32_t)(int32_t)(int8_t)u8 : u8;
+			
+		case 2:
+			memcpy(&u16, data, 2);
+			return sign ? (uint32_t)(int32_t)(int16_t)u16 : u16;
+			
+		default:
+			memcpy(&u32, data, 4);
+			return u32;
+	}
+}
+
+
+
+//Store the lower 1, 2 or 4 bytes of an integer in the byte order of the MCU
+static inline void muCom_storeInt(uint8_t *data, uint32_t value, uint8_t size)
+{
+	uint16_t u16 = (uint16_t)value;
+	
+	switch(size)
+	{
+		case 1:
+			data[0] = (uint8_t)value;
+			break;
+			
+		case 2:
+			memcpy(data, &u16, 2);
+			break;
+			
+		default:
+			memcpy(data, &value, 4);
+			break;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_handleRmw(uint8_t *data, uint8_t cnt)
+{
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	uint8_t prev[4], value[4];
+	uint32_t old, operand, result;
+	uint8_t size, op, sign;
+	
+	if(data[0] == MUCOM_EXT_RMW_ARG)
+	{
+		//Keep the compare value for the following request
+		this->_rmw_arg_cnt = 0;
+		if((cnt >= 3) && (cnt <= 6))
+		{
+			this->_rmw_arg_index = data[1];
+			this->_rmw_arg_cnt = cnt - 2;
+			memcpy(this->_rmw_arg, data + 2, cnt - 2);
+		}
+		return;
+	}
+	
+	if(cnt < 4)
+	{
+		this->_rejectRmw(data[1]);
+		return;
+	}
+	size = cnt - 3;
+	op = data[2] & ~MUCOM_RMW_SIGNED;
+	sign = data[2] & MUCOM_RMW_SIGNED;
+	
+	//Check operation, index and size. A compare-and-swap request needs the compare value of the preceding frame
+	var = this->_findVar(data[1], &entry);
+	if(((size != 1) && (size != 2) && (size != 4)) || (op > MUCOM_RMW_MAX) || (var == NULL) || (size > var->size) ||
+		((op == MUCOM_RMW_CAS) && ((this->_rmw_arg_cnt != size) || (this->_rmw_arg_index != data[1]))))
+	{
+		this->_rmw_arg_cnt = 0;
+		this->_rejectRmw(data[1]);
+		return;
+	}
+	
+	operand = muCom_loadInt(data + 3, size, sign);
+	
+	//Nobody else may access the variable between reading and writing it
+	this->_hw()->_disableInterrupts();
+	this->_loadVar(var, prev, size, 0);
+	old = muCom_loadInt(prev, size, sign);
+	switch(op)
+	{
+		case MUCOM_RMW_ADD:
+			result = old + operand;
+			break;
+			
+		case MUCOM_RMW_CAS:
+			result = (old == muCom_loadInt(this->_rmw_arg, size, sign)) ? operand : old;
+			break;
+			
+		case MUCOM_RMW_SET:
+			result = old | operand;
+			break;
+			
+		case MUCOM_RMW_CLEAR:
+			result = old & ~operand;
+			break;
+			
+		case MUCOM_RMW_TOGGLE:
+			result = old ^ operand;
+			break;
+			
+		case MUCOM_RMW_MIN:
+			result = (sign ? ((int32_t)operand < (int32_t)old) : (operand < old)) ? operand : old;
+			break;
+			
+		default: //MUCOM_RMW_MAX
+			result = (sign ? ((int32_t)operand > (int32_t)old) : (operand > old)) ? operand : old;
+			break;
+	}
+	if(result != old)
+	{
+		muCom_storeInt(value, result, size);
+		this->_storeVar(var, value, size, 0);
+	}
+	this->_hw()->_enableInterrupts();
+	
+	this->_rmw_arg_cnt = 0;
+	#ifndef MUCOM_DEACTIVATE_STATS
+		this->_countAccess(data[1]);
+	#endif
+	
+	//Answer with the previous value like a read request
+	this->writeRaw(MUCOM_READ_RESPONSE, data[1], prev, size);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_rejectRmw(uint8_t index)
+{
+	uint8_t buf[2];
+	
+	//The requester fails immediately instead of waiting for the timeout
+	buf[0] = MUCOM_EXT_RMW_REJECT;
+	buf[1] = index;
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 2);
+}
+#endif
+
+
+
+#ifndef MUCOM_DEACTIVATE_BULK
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_handleBulk(uint8_t *data, uint8_t cnt)
+{
+	struct muCom_BulkTransfer_str *bulk;
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	uint8_t buf[2];
+	uint8_t *addr;
+	uint16_t offset, len, size;
+	uint8_t diff;
+	
+	switch(data[0])
+	{
+		case MUCOM_EXT_BULK_READ:
+		case MUCOM_EXT_BULK_WRITE:
+			if(cnt < 7)
+			{
+				break;
+			}
+			offset = data[2] | ((uint16_t)data[3] << 8);
+			len = data[4] | ((uint16_t)data[5] << 8);
+			
+			if(data[1] == MUCOM_EXT_INDEX)
+			{
+				//Statistics can only be read
+				addr = NULL;
+				size = 0;
+				#ifndef MUCOM_DEACTIVATE_STATS
+					if((FEATURES & MUCOM_FEATURE_STATS) && (data[0] == MUCOM_EXT_BULK_READ) && (this->_stats != NULL))
+					{
+						addr = (uint8_t*)this->_stats;
+						size = sizeof(struct muCom_Stats_str);
+					}
+				#endif
+			}
+			else if((var = this->_findVar(data[1], &entry)) != NULL)
+			{
+				addr = (uint8_t*)var->addr;
+				size = var->size;
+				#ifndef MUCOM_DEACTIVATE_BUFFERED
+					if(var->seq != NULL)
+					{
+						addr = NULL; //Double-buffered variables can not be transferred consistently in several frames
+					}
+				#endif
+			}
+			else
+			{
+				addr = NULL;
+				size = 0;
+			}
+			
+			//Check index, whether a variable is linked and whether the requested range is inside the linked buffer
+			if((addr == NULL) || (len == 0) || (data[6] == 0) || (((uint32_t)offset + len) > size))
+			{
+				//Invalid request! Abort the transfer at the requester
+				buf[0] = MUCOM_EXT_BULK_ABORT;
+				buf[1] = (data[0] == MUCOM_EXT_BULK_READ) ? 0 : 1;
+				this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 2);
+				break;
+			}
+			
+			//A bulk read request is served by sending data, a write request by receiving it
+			bulk = (data[0] == MUCOM_EXT_BULK_READ) ? &this->_bulk_tx : &this->_bulk_rx;
+			this->_hw()->_disableInterrupts();
+			bulk->addr = addr + offset;
+			bulk->len = len;
+			bulk->next = 0;
+			bulk->acked = 0;
+			bulk->window = (data[6] > 127) ? 127 : data[6];
+			bulk->retries = 0;
+			bulk->flags = 0;
+			bulk->status = MUCOM_PENDING;
+			bulk->time = this->_hw()->_getTimestampUs();
+			this->_hw()->_enableInterrupts();
+			break;
+			
+		case MUCOM_EXT_BULK_DATA:
+			bulk = &this->_bulk_rx;
+			if((cnt < 3) || (bulk->addr == NULL))
+			{
+				break;
+			}
+			
+			diff = data[1] - (uint8_t)bulk->next;
+			if(diff >= 0x80)
+			{
+				//Chunk was already received. The sender probably missed the acknowledge
+				if((bulk->status == MUCOM_PENDING) || (bulk->status == MUCOM_OK))
+				{
+					this->_sendBulkAck(0);
+				}
+				break;
+			}
+			
+			if(bulk->status != MUCOM_PENDING)
+			{
+				break;
+			}
+			
+			if(diff != 0)
+			{
+				//At least one chunk got lost. Request a retransmission once
+				if((bulk->flags & MUCOM_BULK_FLAG_NACKED) == 0)
+				{
+					bulk->flags |= MUCOM_BULK_FLAG_NACKED;
+					this->_sendBulkAck(1);
+				}
+				break;
+			}
+			
+			//Store chunk
+			offset = bulk->next * MUCOM_BULK_CHUNK;
+			len = cnt - 2;
+			if((offset + len) > bulk->len)
+			{
+				len = bulk->len - offset;
+			}
+			this->_hw()->_disableInterrupts();
+			memcpy(bulk->addr + offset, data + 2, len);
+			this->_hw()->_enableInterrupts();
+			
+			bulk->next++;
+			bulk->flags &= ~MUCOM_BULK_FLAG_NACKED;
+			bulk->retries = 0;
+			bulk->time = this->_hw()->_getTimestampUs();
+			
+			if((offset + len) >= bulk->len)
+			{
+				bulk->status = MUCOM_OK;
+				this->_sendBulkAck(0);
+			}
+			else if((uint16_t)(bulk->next - bulk->acked) >= ((bulk->window + 1) / 2))
+			{
+				this->_sendBulkAck(0);
+			}
+			break;
+			
+		case MUCOM_EXT_BULK_ACK:
+			bulk = &this->_bulk_tx;
+			if((cnt < 3) || (bulk->addr == NULL) || (bulk->status != MUCOM_PENDING))
+			{
+				break;
+			}
+			
+			diff = data[1] - (uint8_t)bulk->acked;
+			if(diff > (uint16_t)(bulk->next - bulk->acked))
+			{
+				break; //Outdated acknowledge
+			}
+			
+			if(diff != 0)
+			{
+				bulk->acked += diff;
+				bulk->retries = 0;
+				bulk->time = this->_hw()->_getTimestampUs();
+			}
+			
+			if(data[2] != 0)
+			{
+				//Retransmit everything not acknowledged yet
+				bulk->next = bulk->acked;
+			}
+			
+			if((uint32_t)bulk->acked * MUCOM_BULK_CHUNK >= bulk->len)
+			{
+				bulk->status = MUCOM_OK;
+			}
+			break;
+			
+		case MUCOM_EXT_BULK_ABORT:
+			bulk = ((cnt >= 2) && (data[1] != 0)) ? &this->_bulk_tx : &this->_bulk_rx;
+			if(bulk->status == MUCOM_PENDING)
+			{
+				bulk->status = MUCOM_ERR;
+			}
+			break;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_processBulk(void)
+{
+	struct muCom_BulkTransfer_str *bulk;
+	uint8_t buf[2 + MUCOM_BULK_CHUNK];
+	uint16_t offset, chunks;
+	uint8_t len;
+	
+	//Sender: Handle timeouts and send as many chunks as the window allows
+	bulk = &this->_bulk_tx;
+	if((bulk->addr != NULL) && (bulk->status == MUCOM_PENDING))
+	{
+		if((uint32_t)(this->_hw()->_getTimestampUs() - bulk->time) >= this->_timeout)
+		{
+			//No acknowledge received in time
+			bulk->retries++;
+			bulk->time = this->_hw()->_getTimestampUs();
+			if(bulk->retries > MUCOM_BULK_RETRIES)
+			{
+				bulk->status = MUCOM_ERR_TIMEOUT;
+				MUCOM_STATS(timeouts++);
+				return;
+			}
+			
+			bulk->next = bulk->acked;
+			if((bulk->acked == 0) && (bulk->flags & MUCOM_BULK_FLAG_INITIATOR))
+			{
+				//The request itself might have been lost
+				this->_sendBulkRequest(MUCOM_EXT_BULK_WRITE, bulk);
+			}
+		}
+		
+		chunks = (bulk->len + MUCOM_BULK_CHUNK - 1) / MUCOM_BULK_CHUNK;
+		buf[0] = MUCOM_EXT_BULK_DATA;
+		while((bulk->next < chunks) && ((uint16_t)(bulk->next - bulk->acked) < bulk->window))
+		{
+			offset = bulk->next * MUCOM_BULK_CHUNK;
+			len = ((bulk->len - offset) > MUCOM_BULK_CHUNK) ? MUCOM_BULK_CHUNK : (bulk->len - offset);
+			buf[1] = (uint8_t)bulk->next;
+			
+			this->_hw()->_disableInterrupts();
+			memcpy(buf + 2, bulk->addr + offset, len);
+			this->_hw()->_enableInterrupts();
+			
+			this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, len + 2);
+			bulk->next++;
+		}
+	}
+	
+	//Receiver: Handle timeouts
+	bulk = &this->_bulk_rx;
+	if((bulk->addr != NULL) && (bulk->status == MUCOM_PENDING)
+		&& ((uint32_t)(this->_hw()->_getTimestampUs() - bulk->time) >= this->_timeout))
+	{
+		//No data received in time
+		bulk->retries++;
+		bulk->time = this->_hw()->_getTimestampUs();
+		if(bulk->retries > MUCOM_BULK_RETRIES)
+		{
+			bulk->status = MUCOM_ERR_TIMEOUT;
+			MUCOM_STATS(timeouts++);
+			if(bulk->flags & MUCOM_BULK_FLAG_INITIATOR)
+			{
+				//Stop the sender
+				buf[0] = MUCOM_EXT_BULK_ABORT;
+				buf[1] = 1;
+				this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 2);
+			}
+		}
+		else if((bulk->next == 0) && (bulk->flags & MUCOM_BULK_FLAG_INITIATOR))
+		{
+			//The request itself might have been lost
+			this->_sendBulkRequest(MUCOM_EXT_BULK_READ, bulk);
+		}
+		else
+		{
+			this->_sendBulkAck(1);
+		}
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_sendBulkAck(uint8_t retransmit)
+{
+	uint8_t buf[3];
+	
+	buf[0] = MUCOM_EXT_BULK_ACK;
+	buf[1] = (uint8_t)this->_bulk_rx.next;
+	buf[2] = retransmit;
+	this->_bulk_rx.acked = this->_bulk_rx.next;
+	
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 3);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_sendBulkRequest(uint8_t opcode, struct muCom_BulkTransfer_str *bulk)
+{
+	uint8_t buf[7];
+	
+	buf[0] = opcode;
+	buf[1] = bulk->index;
+	buf[2] = bulk->offset & 0xFF;
+	buf[3] = bulk->offset >> 8;
+	buf[4] = bulk->len & 0xFF;
+	buf[5] = bulk->len >> 8;
+	buf[6] = bulk->window;
+	
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 7);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_waitBulk(struct muCom_BulkTransfer_str *bulk)
+{
+	this->flush();
+	this->_hw()->_flushTx(); //Wait for all bytes to be transmitted
+	
+	//handle() processes the transfer until it is finished or aborted after too many timeouts
+	while(bulk->status == MUCOM_PENDING)
+	{
+		this->handle();
+	}
+	
+	return bulk->status;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::setBulkWindow(uint8_t window)
+{
+	if(window == 0)
+	{
+		window = 1;
+	}
+	else if(window > 127)
+	{
+		window = 127;
+	}
+	this->_bulk_window = window;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readBulk(uint8_t index, uint16_t offset, uint8_t *data, uint16_t len)
+{
+	struct muCom_BulkTransfer_str *bulk = &this->_bulk_rx;
+	
+	if(((FEATURES & MUCOM_FEATURE_BULK) == 0) || (len == 0) || (data == NULL) || ((bulk->addr != NULL) && (bulk->status == MUCOM_PENDING)))
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_hw()->_disableInterrupts();
+	bulk->addr = data;
+	bulk->len = len;
+	bulk->offset = offset;
+	bulk->index = index;
+	bulk->next = 0;
+	bulk->acked = 0;
+	bulk->window = this->_bulk_window;
+	bulk->retries = 0;
+	bulk->flags = MUCOM_BULK_FLAG_INITIATOR;
+	bulk->status = MUCOM_PENDING;
+	bulk->time = this->_hw()->_getTimestampUs();
+	this->_hw()->_enableInterrupts();
+	
+	this->_sendBulkRequest(MUCOM_EXT_BULK_READ, bulk);
+	
+	return this->_waitBulk(bulk);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::writeBulk(uint8_t index, uint16_t offset, uint8_t *data, uint16_t len)
+{
+	struct muCom_BulkTransfer_str *bulk = &this->_bulk_tx;
+	
+	if(((FEATURES & MUCOM_FEATURE_BULK) == 0) || (len == 0) || (data == NULL) || ((bulk->addr != NULL) && (bulk->status == MUCOM_PENDING)))
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_hw()->_disableInterrupts();
+	bulk->addr = data;
+	bulk->len = len;
+	bulk->offset = offset;
+	bulk->index = index;
+	bulk->next = 0;
+	bulk->acked = 0;
+	bulk->window = this->_bulk_window;
+	bulk->retries = 0;
+	bulk->flags = MUCOM_BULK_FLAG_INITIATOR;
+	bulk->status = MUCOM_PENDING;
+	bulk->time = this->_hw()->_getTimestampUs();
+	this->_hw()->_enableInterrupts();
+	
+	//The data itself is sent by handle() while waiting for the acknowledges
+	this->_sendBulkRequest(MUCOM_EXT_BULK_WRITE, bulk);
+	
+	return this->_waitBulk(bulk);
+}
+#endif
+
+
+
+#ifndef MUCOM_DEACTIVATE_SUBSCRIPTIONS
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_handleSubscription(uint8_t *data, uint8_t cnt)
+{
+	struct muCom_Subscription_str *sub = NULL;
+	struct muCom_LinkedVariable_str entry;
+	uint8_t i;
+	
+	if(cnt < 2)
+	{
+		return;
+	}
+	
+	if(data[0] == MUCOM_EXT_UNSUBSCRIBE)
+	{
+		for(i = 0; i < MUCOM_SUB_SLOTS; i++)
+		{
+			if((data[1] == MUCOM_EXT_INDEX) || (this->_subs[i].index == data[1]))
+			{
+				this->_subs[i].flags = 0;
+			}
+		}
+		return;
+	}
+	
+	//Check arguments, index and whether a variable is linked
+	if((cnt < 5) || (this->_findVar(data[1], &entry) == NULL))
+	{
+		return;
+	}
+	
+	//Update an existing subscription of this variable or use a free slot
+	for(i = 0; i < MUCOM_SUB_SLOTS; i++)
+	{
+		if(this->_subs[i].flags & MUCOM_SUB_FLAG_ACTIVE)
+		{
+			if(this->_subs[i].index == data[1])
+			{
+				sub = &this->_subs[i];
+				break;
+			}
+		}
+		else if(sub == NULL)
+		{
+			sub = &this->_subs[i];
+		}
+	}
+	
+	if(sub == NULL)
+	{
+		return; //No free slot
+	}
+	
+	sub->index = data[1];
+	sub->period = data[2] | ((uint16_t)data[3] << 8);
+	sub->flags = MUCOM_SUB_FLAG_ACTIVE | MUCOM_SUB_FLAG_FORCE | (data[4] & MUCOM_SUBSCRIBE_ON_CHANGE);
+	
+	//A periodic subscription would otherwise push a frame with each call of handle()
+	if(((sub->flags & MUCOM_SUBSCRIBE_ON_CHANGE) == 0) && (sub->period < MUCOM_MIN_SUB_PERIOD))
+	{
+		sub->period = MUCOM_MIN_SUB_PERIOD;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_processSubscriptions(void)
+{
+	struct muCom_Subscription_str *sub;
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	uint8_t buf[8];
+	uint8_t i, size;
+	uint32_t now = this->_hw()->_getTimestamp();
+	
+	for(i = 0; i < MUCOM_SUB_SLOTS; i++)
+	{
+		sub = &this->_subs[i];
+		if((sub->flags & MUCOM_SUB_FLAG_ACTIVE) == 0)
+		{
+			continue;
+		}
+		
+		//The variable might have been relinked in the meantime
+		var = this->_findVar(sub->index, &entry);
+		if(var == NULL)
+		{
+			sub->flags = 0;
+			continue;
+		}
+		
+		if(((sub->flags & MUCOM_SUB_FLAG_FORCE) == 0) && ((uint32_t)(now - sub->last) < sub->period))
+		{
+			continue; //Not due yet
+		}
+		
+		size = (var->size > 8) ? 8 : var->size;
+		this->_loadVar(var, buf, size, 1);
+		
+		if(((sub->flags & (MUCOM_SUB_FLAG_FORCE | MUCOM_SUBSCRIBE_ON_CHANGE)) == MUCOM_SUBSCRIBE_ON_CHANGE)
+			&& (this->_hasChanged(var, sub, buf, size) == 0))
+		{
+			continue; //Unchanged
+		}
+		memcpy(sub->shadow, buf, size);
+		
+		sub->last = now;
+		sub->flags &= ~MUCOM_SUB_FLAG_FORCE;
+		
+		this->writeRaw(MUCOM_READ_RESPONSE, sub->index, buf, size);
+	}
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_DISCOVERY
+//Convert a numeric linked variable to double for deadband checks
+static inline double muCom_toDouble(muCom_LinkedVariableType type, const uint8_t *data)
+{
+	union
+	{
+		int8_t i8;
+		int16_t i16;
+		int32_t i32;
+		int64_t i64;
+		uint8_t u8;
+		uint16_t u16;
+		uint32_t u32;
+		uint64_t u64;
+		float f32;
+		double f64;
+		uint8_t raw[8];
+	} value;
+	
+	memcpy(value.raw, data, 8);
+	switch(type)
+	{
+		case MUCOM_INT8:	return value.i8;
+		case MUCOM_INT16:	return value.i16;
+		case MUCOM_INT32:	return value.i32;
+		case MUCOM_INT64:	return (double)value.i64;
+		case MUCOM_UINT8:	return value.u8;
+		case MUCOM_UINT16:	return value.u16;
+		case MUCOM_UINT32:	return value.u32;
+		case MUCOM_UINT64:	return (double)value.u64;
+		case MUCOM_FLOAT:	return value.f32;
+		case MUCOM_DOUBLE:	return value.f64;
+		default:			return 0.0;
+	}
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_hasChanged(const struct muCom_LinkedVariable_str *var, const struct muCom_Subscription_str *sub, uint8_t *value, uint8_t size)
+{
+	const struct muCom_PublishedVariable_str *pub;
+	
+	if(memcmp(value, sub->shadow, size) == 0)
+	{
+		return 0;
+	}
+	
+	#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		//Ignore changes within the deadband. Requires the type of the variable, which is stored unless discovery is deactivated
+		pub = (sub->index < this->_published_num) ? &this->_published[sub->index] : NULL;
+		if((pub != NULL) && (pub->deadband > 0) && (var->type != MUCOM_ARRAY))
+		{
+			double last = muCom_toDouble(var->type, sub->shadow);
+			double diff = muCom_toDouble(var->type, value) - last;
+			double limit = pub->deadband;
+			
+			if(diff < 0)
+			{
+				diff = -diff;
+			}
+			if(pub->flags & MUCOM_DEADBAND_RELATIVE)
+			{
+				limit *= (last < 0) ? -last : last;
+			}
+			
+			return (diff > limit) ? 1 : 0;
+		}
+	#else
+		(void)var;
+		(void)pub;
+	#endif
+	
+	return 1;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::linkPublishBuffer(struct muCom_PublishedVariable_str *buf, uint8_t num)
+{
+	if(buf != NULL)
+	{
+		memset(buf, 0, num * sizeof(struct muCom_PublishedVariable_str));
+	}
+	
+	this->_hw()->_disableInterrupts();
+	this->_published = buf;
+	this->_published_num = (buf != NULL) ? num : 0;
+	this->_hw()->_enableInterrupts();
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::setDeadband(uint8_t index, float deadband, uint8_t mode)
+{
+	#ifdef MUCOM_DEACTIVATE_DISCOVERY
+		//The types of the linked variables are not stored
+		if(deadband > 0)
+		{
+			return MUCOM_ERR;
+		}
+	#endif
+	
+	if((index >= this->_published_num) || (deadband < 0))
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_published[index].deadband = deadband;
+	this->_published[index].flags = mode & MUCOM_DEADBAND_RELATIVE;
+	
+	return MUCOM_OK;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::subscribe(uint8_t index, uint16_t period, uint8_t mode)
+{
+	uint8_t buf[5];
+	
+	buf[0] = MUCOM_EXT_SUBSCRIBE;
+	buf[1] = index;
+	buf[2] = period & 0xFF;
+	buf[3] = period >> 8;
+	buf[4] = mode;
+	
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 5);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::unsubscribe(uint8_t index)
+{
+	uint8_t buf[2];
+	
+	buf[0] = MUCOM_EXT_UNSUBSCRIBE;
+	buf[1] = index;
+	
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 2);
+}
+#endif
+
+
+
+#ifndef MUCOM_DEACTIVATE_STATS
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::linkStats(struct muCom_Stats_str *stats)
+{
+	if(stats != NULL)
+	{
+		memset(stats, 0, sizeof(struct muCom_Stats_str));
+	}
+	
+	this->_hw()->_disableInterrupts();
+	this->_stats = stats;
+	this->_hw()->_enableInterrupts();
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_countAccess(uint16_t index)
+{
+	if((FEATURES & MUCOM_FEATURE_STATS) && (this->_stats != NULL) && (index < MUCOM_STATS_INDICES))
+	{
+		this->_stats->access[index]++;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_countLatency(uint32_t latency)
+{
+	uint8_t bucket = 0;
+	
+	if(((FEATURES & MUCOM_FEATURE_STATS) == 0) || (this->_stats == NULL))
+	{
+		return;
+	}
+	
+	//Logarithmic buckets: The bucket is the number of significant bits of the latency
+	while((latency != 0) && (bucket < (MUCOM_STATS_BUCKETS - 1)))
+	{
+		latency >>= 1;
+		bucket++;
+	}
+	this->_stats->latency[bucket]++;
+}
+#endif
+
+
+
+//Position of the entry of an index in a table sorted by index or the position a new entry has to be inserted at.
+//PGM is 1 for constant tables, which may be located in flash
+template<uint8_t PGM, typename T>
+static inline uint16_t muCom_searchEntry(const T *table, uint16_t cnt, uint16_t index)
+{
+	uint16_t low = 0, mid;
+	
+	//The indices are unique, so the entry of an index is never located behind the position equal to the index.
+	//Tables with indices starting at 0 without gaps are accessed directly
+	if(index < cnt)
+	{
+		if((PGM ? MUCOM_PGM_INDEX(&table[index]) : table[index].index) == index)
+		{
+			return index;
+		}
+		cnt = index;
+	}
+	
+	while(low < cnt)
+	{
+		mid = low + ((cnt - low) >> 1);
+		if((PGM ? MUCOM_PGM_INDEX(&table[mid]) : table[mid].index) < index)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			cnt = mid;
+		}
+	}
+	
+	return low;
+}
+
+
+
+//Get the entry of an index from a table sorted by index. A new entry is inserted if there is none yet. NULL if the table is full
+template<typename T>
+static T* muCom_insertEntry(T *table, uint16_t *cnt, uint16_t num, uint16_t index)
+{
+	uint16_t pos = muCom_searchEntry<0>(table, *cnt, index);
+	
+	if((pos >= *cnt) || (table[pos].index != index))
+	{
+		if(*cnt >= num)
+		{
+			return NULL;
+		}
+		memmove(&table[pos + 1], &table[pos], (*cnt - pos) * sizeof(T));
+		memset(&table[pos], 0, sizeof(T));
+		table[pos].index = index;
+		(*cnt)++;
+	}
+	
+	return &table[pos];
+}
+
+
+
+//Remove the entry of an index from a table sorted by index
+template<typename T>
+static void muCom_removeEntry(T *table, uint16_t *cnt, uint16_t index)
+{
+	uint16_t pos = muCom_searchEntry<0>(table, *cnt, index);
+	
+	if((pos < *cnt) && (table[pos].index == index))
+	{
+		(*cnt)--;
+		memmove(&table[pos], &table[pos + 1], (*cnt - pos) * sizeof(T));
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+const struct muCom_LinkedVariable_str* MUCOM_CORE::_findVar(uint16_t index, struct muCom_LinkedVariable_str *buf)
+{
+	uint16_t pos = muCom_searchEntry<0>(this->_linked_var, this->_linked_var_cnt, index);
+	
+	if((pos < this->_linked_var_cnt) && (this->_linked_var[pos].index == index))
+	{
+		return &this->_linked_var[pos];
+	}
+	
+	#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+		//Variables linked at runtime take precedence over the constant table
+		pos = muCom_searchEntry<1>(this->_const_var, this->_const_var_cnt, index);
+		if((pos < this->_const_var_cnt) && (MUCOM_PGM_INDEX(&this->_const_var[pos]) == index))
+		{
+			MUCOM_PGM_COPY(buf, &this->_const_var[pos], sizeof(struct muCom_LinkedVariable_str));
+			return buf;
+		}
+	#else
+		(void)buf;
+	#endif
+	
+	return NULL;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+muComFunc MUCOM_CORE::_findFunc(uint16_t index)
+{
+	uint16_t pos = muCom_searchEntry<0>(this->_linked_func, this->_linked_func_cnt, index);
+	
+	#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+		muComFunc func;
+	#endif
+	
+	if((pos < this->_linked_func_cnt) && (this->_linked_func[pos].index == index))
+	{
+		return this->_linked_func[pos].func;
+	}
+	
+	#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+		//Functions linked at runtime take precedence over the constant table
+		pos = muCom_searchEntry<1>(this->_const_func, this->_const_func_cnt, index);
+		if((pos < this->_const_func_cnt) && (MUCOM_PGM_INDEX(&this->_const_func[pos]) == index))
+		{
+			MUCOM_PGM_COPY(&func, &this->_const_func[pos].func, sizeof(muComFunc));
+			return func;
+		}
+	#endif
+	
+	return NULL;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::linkFunction(uint16_t index, muComFunc function)
+{
+	struct muCom_LinkedFunction_str *entry;
+	int8_t ret = MUCOM_OK;
+	
+	if(index == MUCOM_EXT_INDEX)
+	{
+		return MUCOM_ERR; //Reserved for extended frames
+	}
+	
+	//The table is reordered, so keep handle() from accessing it in the meantime
+	this->_hw()->_disableInterrupts();
+	if(function == NULL)
+	{
+		muCom_removeEntry(this->_linked_func, &this->_linked_func_cnt, index);
+	}
+	else
+	{
+		entry = muCom_insertEntry(this->_linked_func, &this->_linked_func_cnt, this->_linked_func_num, index);
+		if(entry != NULL)
+		{
+			entry->func = function;
+		}
+		else
+		{
+			ret = MUCOM_ERR; //No free entry
+		}
+	}
+	this->_hw()->_enableInterrupts();
+	
+	#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		this->_table_hash_valid = 0;
+	#endif
+	
+	return ret;
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::linkTable(const struct muCom_LinkedVariable_str *var, uint16_t num_var, const struct muCom_LinkedFunction_str *func, uint16_t num_func)
+{
+	uint16_t i;
+	
+	if(var == NULL)
+	{
+		num_var = 0;
+	}
+	if(func == NULL)
+	{
+		num_func = 0;
+	}
+	
+	//The lookup relies on ascending indices
+	for(i = 1; i < num_var; i++)
+	{
+		if(MUCOM_PGM_INDEX(&var[i - 1]) >= MUCOM_PGM_INDEX(&var[i]))
+		{
+			return MUCOM_ERR;
+		}
+	}
+	for(i = 0; i < num_func; i++)
+	{
+		if((MUCOM_PGM_INDEX(&func[i]) == MUCOM_EXT_INDEX) || ((i != 0) && (MUCOM_PGM_INDEX(&func[i - 1]) >= MUCOM_PGM_INDEX(&func[i]))))
+		{
+			return MUCOM_ERR;
+		}
+	}
+	
+	this->_hw()->_disableInterrupts();
+	this->_const_var = var;
+	this->_const_var_cnt = num_var;
+	this->_const_func = func;
+	this->_const_func_cnt = num_func;
+	this->_hw()->_enableInterrupts();
+	
+	#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		this->_table_hash_valid = 0;
+	#endif
+	
+	return MUCOM_OK;
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+#ifndef MUCOM_DEACTIVATE_DISCOVERY
+int8_t MUCOM_CORE::_linkVariable(uint16_t index, uint8_t *var, uint16_t size, muCom_LinkedVariableType type)
+{
+	return this->_insertVar(index, var, size, NULL, type);
+}
+#else
+int8_t MUCOM_CORE::linkVariable(uint16_t index, uint8_t *var, uint16_t size)
+{
+	return this->_insertVar(index, var, size, NULL, MUCOM_ARRAY);
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_insertVar(uint16_t index, uint8_t *var, uint16_t size, volatile uint8_t *seq, muCom_LinkedVariableType type)
+{
+	struct muCom_LinkedVariable_str *entry;
+	int8_t ret = MUCOM_OK;
+	
+	//The table is reordered, so keep handle() from accessing it in the meantime. The entry is complete before handle() sees it
+	this->_hw()->_disableInterrupts();
+	if(var == NULL)
+	{
+		muCom_removeEntry(this->_linked_var, &this->_linked_var_cnt, index);
+	}
+	else
+	{
+		entry = muCom_insertEntry(this->_linked_var, &this->_linked_var_cnt, this->_linked_var_num, index);
+		if(entry != NULL)
+		{
+			entry->addr = var;
+			entry->size = size;
+			#ifndef MUCOM_DEACTIVATE_BUFFERED
+				entry->seq = seq;
+			#else
+				(void)seq;
+			#endif
+			#ifndef MUCOM_DEACTIVATE_DISCOVERY
+				entry->type = type;
+			#else
+				(void)type;
+			#endif
+		}
+		else
+		{
+			ret = MUCOM_ERR; //No free entry
+		}
+	}
+	this->_hw()->_enableInterrupts();
+	
+	#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		this->_table_hash_valid = 0;
+	#endif
+	
+	return ret;
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_BUFFERED
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_linkBuffered(uint16_t index, uint8_t *var, uint16_t size, volatile uint8_t *seq, muCom_LinkedVariableType type)
+{
+	//The sequence counter is set together with the address, so handle() never accesses the copies as a plain variable
+	return this->_insertVar(index, var, size, seq, type);
+}
+#endif
+
+
+
+#ifndef MUCOM_DEACTIVATE_DISCOVERY
+//Add a byte to a FNV-1a hash
+static inline uint32_t muCom_hashByte(uint32_t hash, uint8_t data)
+{
+	return (hash ^ data) * 16777619UL;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+const struct muCom_LinkedVariable_str* MUCOM_CORE::_nextVar(uint16_t *pos, struct muCom_LinkedVariable_str *buf)
+{
+	#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+		uint16_t index;
+		
+		//pos[0] walks the linked variables, pos[1] the constant table. Both are merged in index order
+		while(pos[1] < this->_const_var_cnt)
+		{
+			index = MUCOM_PGM_INDEX(&this->_const_var[pos[1]]);
+			if((pos[0] < this->_linked_var_cnt) && (this->_linked_var[pos[0]].index < index))
+			{
+				break;
+			}
+			if((pos[0] < this->_linked_var_cnt) && (this->_linked_var[pos[0]].index == index))
+			{
+				pos[1]++; //Overridden by a variable linked at runtime
+				continue;
+			}
+			MUCOM_PGM_COPY(buf, &this->_const_var[pos[1]], sizeof(struct muCom_LinkedVariable_str));
+			pos[1]++;
+			return buf;
+		}
+	#else
+		(void)buf;
+	#endif
+	
+	if(pos[0] < this->_linked_var_cnt)
+	{
+		return &this->_linked_var[pos[0]++];
+	}
+	
+	return NULL;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_nextFunc(uint16_t *pos, uint16_t *index)
+{
+	#ifndef MUCOM_DEACTIVATE_CONST_TABLE
+		//Same as _nextVar()
+		while(pos[1] < this->_const_func_cnt)
+		{
+			*index = MUCOM_PGM_INDEX(&this->_const_func[pos[1]]);
+			if((pos[0] < this->_linked_func_cnt) && (this->_linked_func[pos[0]].index < *index))
+			{
+				break;
+			}
+			pos[1]++;
+			if((pos[0] < this->_linked_func_cnt) && (this->_linked_func[pos[0]].index == *index))
+			{
+				continue;
+			}
+			return 1;
+		}
+	#endif
+	
+	if(pos[0] < this->_linked_func_cnt)
+	{
+		*index = this->_linked_func[pos[0]++].index;
+		return 1;
+	}
+	
+	return 0;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint32_t MUCOM_CORE::_tableHash(void)
+{
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	uint32_t hash = 2166136261UL;
+	uint16_t pos[2] = {0, 0};
+	uint16_t index;
+	
+	if(this->_table_hash_valid != 0)
+	{
+		return this->_table_hash;
+	}
+	
+	//The upper byte of an index is only added if it is used, so tables with 8 bit indices keep their hash
+	while((var = this->_nextVar(pos, &entry)) != NULL)
+	{
+		hash = muCom_hashByte(hash, var->index & 0xFF);
+		if(var->index > 0xFF)
+		{
+			hash = muCom_hashByte(hash, var->index >> 8);
+		}
+		hash = muCom_hashByte(hash, var->size & 0xFF);
+		hash = muCom_hashByte(hash, var->size >> 8);
+		hash = muCom_hashByte(hash, var->type);
+	}
+	hash = muCom_hashByte(hash, MUCOM_EXT_INDEX); //Separates variables and functions
+	pos[0] = 0;
+	pos[1] = 0;
+	while(this->_nextFunc(pos, &index) != 0)
+	{
+		hash = muCom_hashByte(hash, index & 0xFF);
+		if(index > 0xFF)
+		{
+			hash = muCom_hashByte(hash, index >> 8);
+		}
+	}
+	
+	this->_table_hash = hash;
+	this->_table_hash_valid = 1;
+	
+	return hash;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_handleDiscovery(uint8_t *data, uint8_t cnt)
+{
+	struct muCom_Table_str *table = this->_table;
+	struct muCom_LinkedVariable_str entry;
+	const struct muCom_LinkedVariable_str *var;
+	uint8_t buf[1 + MUCOM_EXT_MAX_ARGS];
+	uint8_t len = 1, page = 0;
+	uint8_t full = ((cnt >= 2) && (data[1] == MUCOM_DISCOVER_TABLE)) ? 1 : 0;
+	uint16_t pos[2] = {0, 0};
+	uint16_t i, index, num_var = 0, num_func = 0;
+	uint32_t hash;
+	
+	switch(data[0])
+	{
+		case MUCOM_EXT_DISCOVER:
+			hash = this->_tableHash();
+			while((var = this->_nextVar(pos, &entry)) != NULL)
+			{
+				num_var++;
+				if(full == 0)
+				{
+					continue;
+				}
+				buf[0] = MUCOM_EXT_TABLE_VAR;
+				buf[1] = var->index & 0xFF;
+				buf[2] = var->size & 0xFF;
+				buf[3] = var->size >> 8;
+				buf[4] = var->type;
+				buf[5] = var->index >> 8;
+				this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 6);
+			}
+			
+			//Up to MUCOM_EXT_MAX_ARGS function indices per frame. Indices above 255 are sent in frames per upper byte
+			pos[0] = 0;
+			pos[1] = 0;
+			while(this->_nextFunc(pos, &index) != 0)
+			{
+				num_func++;
+				if(full == 0)
+				{
+					continue;
+				}
+				if((len > 1) && (((index >> 8) != page) || (len > MUCOM_EXT_MAX_ARGS)))
+				{
+					this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, len);
+					len = 1;
+				}
+				if(len == 1)
+				{
+					page = index >> 8;
+					buf[0] = (page == 0) ? MUCOM_EXT_TABLE_FUNC : MUCOM_EXT_TABLE_FUNC_PAGE;
+					if(page != 0)
+					{
+						buf[len++] = page;
+					}
+				}
+				buf[len++] = index & 0xFF;
+			}
+			if(len > 1)
+			{
+				this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, len);
+			}
+			
+			//The hash terminates the answer
+			buf[0] = MUCOM_EXT_TABLE_HASH;
+			buf[1] = hash & 0xFF;
+			buf[2] = (hash >> 8) & 0xFF;
+			buf[3] = (hash >> 16) & 0xFF;
+			buf[4] = hash >> 24;
+			buf[5] = num_var & 0xFF;
+			buf[6] = num_func & 0xFF;
+			this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 7);
+			break;
+			
+		case MUCOM_EXT_TABLE_VAR:
+			if((table == NULL) || (this->_table_status != MUCOM_PENDING) || (cnt < 5))
+			{
+				break;
+			}
+			if(table->num_var >= MUCOM_MAX_TABLE)
+			{
+				this->_table_status = MUCOM_ERR; //Table too small
+				break;
+			}
+			table->var[table->num_var].index = data[1] | ((cnt >= 6) ? ((uint16_t)data[5] << 8) : 0);
+			table->var[table->num_var].size = data[2] | ((uint16_t)data[3] << 8);
+			table->var[table->num_var].type = (muCom_LinkedVariableType)data[4];
+			table->num_var++;
+			this->_table_time = this->_hw()->_getTimestampUs();
+			break;
+			
+		case MUCOM_EXT_TABLE_FUNC:
+		case MUCOM_EXT_TABLE_FUNC_PAGE:
+			if((table == NULL) || (this->_table_status != MUCOM_PENDING))
+			{
+				break;
+			}
+			i = 1;
+			if(data[0] == MUCOM_EXT_TABLE_FUNC_PAGE)
+			{
+				page = data[1];
+				i = 2;
+			}
+			for(; i < cnt; i++)
+			{
+				if(table->num_func >= MUCOM_MAX_TABLE)
+				{
+					this->_table_status = MUCOM_ERR; //Table too small
+					break;
+				}
+				table->func[table->num_func++] = data[i] | ((uint16_t)page << 8);
+			}
+			this->_table_time = this->_hw()->_getTimestampUs();
+			break;
+			
+		case MUCOM_EXT_TABLE_HASH:
+			if((this->_table_status != MUCOM_PENDING) || (cnt < 7))
+			{
+				break;
+			}
+			this->_table_hash_rx = data[1] | ((uint32_t)data[2] << 8) | ((uint32_t)data[3] << 16) | ((uint32_t)data[4] << 24);
+			this->_table_status = MUCOM_OK;
+			if(table != NULL)
+			{
+				table->hash = this->_table_hash_rx;
+				if((table->num_var != data[5]) || (table->num_func != data[6]))
+				{
+					this->_table_status = MUCOM_ERR_COMM; //Frames got lost
+				}
+			}
+			break;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_discover(uint8_t mode)
+{
+	uint8_t buf[2];
+	int8_t status;
+	
+	//Flush receive buffer
+	this->handle();
+	
+	this->_table_status = MUCOM_PENDING;
+	this->_table_time = this->_hw()->_getTimestampUs();
+	
+	buf[0] = MUCOM_EXT_DISCOVER;
+	buf[1] = mode;
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, 2);
+	this->flush();
+	this->_hw()->_flushTx(); //Wait for all bytes to be transmitted
+	
+	//The timeout restarts with every table frame, so large tables do not need a larger timeout
+	while(this->_table_status == MUCOM_PENDING)
+	{
+		this->handle();
+		if((uint32_t)(this->_hw()->_getTimestampUs() - this->_table_time) >= this->_timeout)
+		{
+			this->_table_status = MUCOM_ERR_TIMEOUT;
+			MUCOM_STATS(timeouts++);
+		}
+	}
+	
+	status = this->_table_status;
+	this->_table = NULL;
+	
+	return status;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readTableHash(uint32_t *hash)
+{
+	int8_t status;
+	
+	if(((FEATURES & MUCOM_FEATURE_DISCOVERY) == 0) || (hash == NULL))
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_table = NULL;
+	status = this->_discover(MUCOM_DISCOVER_HASH);
+	if(status == MUCOM_OK)
+	{
+		*hash = this->_table_hash_rx;
+	}
+	
+	return status;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::discover(struct muCom_Table_str *table)
+{
+	if(((FEATURES & MUCOM_FEATURE_DISCOVERY) == 0) || (table == NULL))
+	{
+		return MUCOM_ERR;
+	}
+	
+	memset(table, 0, sizeof(struct muCom_Table_str));
+	this->_table = table;
+	
+	return this->_discover(MUCOM_DISCOVER_TABLE);
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_writeRaw(uint8_t frameDesc, uint16_t index, uint16_t offset, uint8_t *data, uint8_t size)
+{
+	uint8_t buf[MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];
+	uint8_t len;
+	
+	if(size == 0)
+	{
+		return MUCOM_ERR;
+	}
+	if(size > 8)
+	{
+		size = 8;
+	}
+	
+	len = muCom_encodeFrame(buf, frameDesc, index & 0xFF, data, size);
+	
+	if(this->_lockTx() != MUCOM_OK)
+	{
+		return MUCOM_ERR_TIMEOUT;
+	}
+	
+	this->_sendPrefix(index, offset);
+	this->_send(buf, len); //Send write variable request to slave
+	
+	this->_unlockTx();
+	
+	return MUCOM_OK;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_tryWriteRaw(uint8_t frameDesc, uint16_t index, uint8_t *data, uint8_t size)
+{
+	uint8_t buf[MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];
+	uint8_t len;
+	uint16_t need;
+	int8_t ret = MUCOM_OK;
+	
+	if((size == 0) || (size > 8) || (data == NULL))
+	{
+		return MUCOM_ERR;
+	}
+	
+	len = muCom_encodeFrame(buf, frameDesc, index & 0xFF, data, size);
+	
+	//Frame and page frame (2 data bytes) must fit
+	need = len;
+	if(index > 0xFF)
+	{
+		need += muCom_getFrameLength(MUCOM_HEADER_BIT_MASK + MUCOM_EXECUTE_REQUEST + ((2 - 1) << 2));
+	}
+	#ifndef MUCOM_DEACTIVATE_CRC
+		if((FEATURES & MUCOM_FEATURE_CRC) && this->_crc)
+		{
+			need += (index > 0xFF) ? (2 * MUCOM_CRC_LEN) : MUCOM_CRC_LEN;
+		}
+	#endif
+	
+	this->_lockTxNoWait();
+	
+	//Unless the frame is only collected, the collected frames are written together with it
+	if((this->_txCollecting() == 0) && (this->_txSpace() < (need + this->_txCollected())))
+	{
+		this->_tx_busy = 1;
+		this->_unlockTx();
+		MUCOM_STATS(tx_waits++);
+		return MUCOM_ERR_BUSY;
+	}
+	
+	this->_sendPrefix(index, 0);
+	this->_send(buf, len);
+	
+	#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+		if(this->_tx_cnt != 0)
+		{
+			ret = MUCOM_QUEUED;
+		}
+	#endif
+	#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+		if(this->_txq_head != this->_txq_tail)
+		{
+			ret = MUCOM_QUEUED;
+		}
+	#endif
+	
+	this->_unlockTx();
+	
+	return ret;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_sendPrefix(uint16_t index, uint16_t offset)
+{
+	uint8_t buf[MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];
+	uint8_t data[4];
+	
+	if(offset != 0)
+	{
+		//The offset frame holds the upper index byte as well
+		data[0] = MUCOM_EXT_OFFSET;
+		data[1] = offset & 0xFF;
+		data[2] = offset >> 8;
+		data[3] = index >> 8;
+		this->_send(buf, muCom_encodeFrame(buf, MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, data, 4));
+	}
+	else if(index > 0xFF)
+	{
+		data[0] = MUCOM_EXT_PAGE;
+		data[1] = index >> 8;
+		this->_send(buf, muCom_encodeFrame(buf, MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, data, 2));
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_lockTx(void)
+{
+	uint32_t time_start = 0;
+	uint16_t need;
+	uint8_t wait = ((FEATURES & MUCOM_FEATURE_THREADLOCK) || this->_txQueueActive()) ? 1 : 0; //The queue must not overflow
+	
+	while(1)
+	{
+		this->_lockTxNoWait();
+		
+		//Wait for sufficient space or a timeout occurs. 2x the frame buffer should be sufficient to not encounter collisions
+		//Not needed if the frame is only collected. Collected frames are put into the queue first
+		need = 2 * sizeof(this->_rcv_buf);
+		if(this->_txQueueActive())
+		{
+			need += this->_txCollected();
+		}
+		if((wait == 0) || this->_txCollecting() || (this->_txSpace() >= need))
+		{
+			return MUCOM_OK; //Stays locked
+		}
+		
+		this->_unlockTx();
+		
+		if(wait == 1)
+		{
+			wait = 2;
+			time_start = this->_hw()->_getTimestampUs();
+			MUCOM_STATS(tx_waits++);
+		}
+		else if((uint32_t)(this->_hw()->_getTimestampUs() - time_start) >= this->_timeout)
+		{
+			MUCOM_STATS(timeouts++);
+			return MUCOM_ERR_TIMEOUT; //Timeout
+		}
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_lockTxNoWait(void)
+{
+	if(FEATURES & MUCOM_FEATURE_THREADLOCK)
+	{
+		this->_hw()->_disableInterrupts();
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_unlockTx(void)
+{
+	if(FEATURES & MUCOM_FEATURE_THREADLOCK)
+	{
+		this->_hw()->_enableInterrupts();
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_send(uint8_t *frame, uint8_t len)
+{
+	#ifndef MUCOM_DEACTIVATE_CRC
+		if((FEATURES & MUCOM_FEATURE_CRC) && this->_crc)
+		{
+			//Append sequence number and CRC and keep the frame for retransmissions
+			frame[len] = this->_tx_seq;
+			frame[len + 1] = muCom_crc7(frame, len + 1);
+			len += MUCOM_CRC_LEN;
+			memcpy(this->_tx_ring[this->_tx_seq % MUCOM_CRC_SLOTS], frame, len);
+			this->_tx_seq = (this->_tx_seq + 1) & 0x7F;
+		}
+	#endif
+	
+	#ifndef MUCOM_DEACTIVATE_CAPTURE
+		if(this->_capture_func != NULL)
+		{
+			this->_captureFrame(MUCOM_CAPTURE_FRAME_TX, frame);
+		}
+	#endif
+	
+	this->_output(frame, len);
+	MUCOM_STATS(frames_sent++);
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_CAPTURE
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_captureFrame(uint8_t type, const uint8_t *frame)
+{
+	uint8_t raw[MUCOM_MAX_FRAME_LEN];
+	uint8_t buf[1 + MUCOM_MAX_PAYLOAD_LEN];
+	uint8_t len;
+	
+	//The decoder reads a complete frame buffer, read requests are shorter
+	len = muCom_getFrameLength(frame[0]);
+	memset(raw, 0, sizeof(raw));
+	memcpy(raw, frame, len);
+	
+	//Header without sync bit (frame descriptor and data byte count), index byte and data bytes. Read requests have no data bytes
+	buf[0] = frame[0] & (MUCOM_FRAME_DESC_MASK | MUCOM_DATA_BYTE_CNT_MASK);
+	muCom_decodeFrame(raw, buf + 1);
+	if((frame[0] & MUCOM_FRAME_DESC_MASK) == MUCOM_READ_REQUEST)
+	{
+		len = 2;
+	}
+	else
+	{
+		len = 3 + ((frame[0] & MUCOM_DATA_BYTE_CNT_MASK) >> 2);
+	}
+	this->_capture_func(this->_capture_ctx, type, buf, len);
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_output(const uint8_t *frame, uint8_t len)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+		if((FEATURES & MUCOM_FEATURE_TX_COALESCING) && (this->_tx_threshold != 0))
+		{
+			if((this->_tx_cnt + len) > MUCOM_TXBUF_SIZE)
+			{
+				this->_flushBuffer();
+			}
+			memcpy(&this->_tx_buf[this->_tx_cnt], frame, len);
+			this->_tx_cnt += len;
+			if(this->_tx_cnt >= this->_tx_threshold)
+			{
+				this->_flushBuffer();
+			}
+			return;
+		}
+	#endif
+	
+	this->_writeHw((uint8_t*)frame, len);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_txCollecting(void)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+		//Nothing is written as long as the largest frame with page frame fits below the threshold
+		if((this->_tx_threshold != 0) && ((this->_tx_cnt + 2 * (MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN)) < this->_tx_threshold))
+		{
+			return 1;
+		}
+	#endif
+	
+	return 0;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_txCollected(void)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+		return this->_tx_cnt;
+	#else
+		return 0;
+	#endif
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::flush(void)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+		if(this->_tx_cnt == 0)
+		{
+			return;
+		}
+		
+		if(this->_txQueueActive())
+		{
+			//Never waits. The frames stay collected while the queue is full
+			this->_lockTxNoWait();
+			if(this->_txSpace() >= this->_tx_cnt)
+			{
+				this->_flushBuffer();
+			}
+			this->_unlockTx();
+			return;
+		}
+		
+		if(this->_lockTx() != MUCOM_OK)
+		{
+			return;
+		}
+		this->_flushBuffer();
+		this->_unlockTx();
+	#endif
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_TX_COALESCING
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_flushBuffer(void)
+{
+	if(this->_tx_cnt != 0)
+	{
+		this->_writeHw(this->_tx_buf, this->_tx_cnt);
+		this->_tx_cnt = 0;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::setTxCoalescing(uint8_t threshold)
+{
+	if(((FEATURES & MUCOM_FEATURE_TX_COALESCING) == 0) && (threshold != 0))
+	{
+		return MUCOM_ERR;
+	}
+	
+	if(this->_lockTx() != MUCOM_OK)
+	{
+		return MUCOM_ERR_TIMEOUT;
+	}
+	
+	//Frames collected so far are written with the old setting
+	this->_flushBuffer();
+	#if MUCOM_TX_BUFFER < 255
+		if(threshold > MUCOM_TX_BUFFER)
+		{
+			threshold = MUCOM_TX_BUFFER;
+		}
+	#endif
+	this->_tx_threshold = threshold;
+	
+	this->_unlockTx();
+	
+	return MUCOM_OK;
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_writeHw(uint8_t *data, uint8_t len)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+		uint16_t pos, part;
+		
+		if(this->_txQueueActive())
+		{
+			//_lockTx() made sure the data fits, unless the interface was not locked
+			if(len > (MUCOM_TXQ_SIZE - (uint16_t)(this->_txq_head - this->_txq_tail)))
+			{
+				MUCOM_STATS(timeouts++);
+				return;
+			}
+			
+			pos = this->_txq_head & (MUCOM_TXQ_SIZE - 1);
+			part = MUCOM_TXQ_SIZE - pos;
+			if(part > len)
+			{
+				part = len;
+			}
+			memcpy(&this->_txq[pos], data, part);
+			memcpy(this->_txq, data + part, len - part);
+			this->_txq_head += len;
+			
+			this->_drainTx();
+			return;
+		}
+	#endif
+	
+	MUCOM_CAPTURE(MUCOM_CAPTURE_TX, data, len);
+	this->_hw()->_write(data, len);
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::_txQueueActive(void)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+		if((FEATURES & MUCOM_FEATURE_TX_QUEUE) && this->_txq_active)
+		{
+			return 1;
+		}
+	#endif
+	
+	return 0;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint16_t MUCOM_CORE::_txSpace(void)
+{
+	#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+		if(this->_txQueueActive())
+		{
+			this->_drainTx();
+			return MUCOM_TXQ_SIZE - (uint16_t)(this->_txq_head - this->_txq_tail);
+		}
+	#endif
+	
+	return this->_hw()->_availableTxBuffer();
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_processTx(void)
+{
+	uint16_t space = 0;
+	
+	if((this->_tx_busy == 0) && (this->_txQueueActive() == 0))
+	{
+		return;
+	}
+	
+	this->_lockTxNoWait();
+	
+	//Write queued frames. Rejected frames may be sent again as soon as a frame with page frame fits besides the collected frames
+	space = this->_txSpace();
+	if((this->_tx_busy == 0) || (space < (2 * sizeof(this->_rcv_buf) + this->_txCollected())))
+	{
+		space = 0;
+	}
+	else
+	{
+		this->_tx_busy = 0;
+		space -= this->_txCollected();
+	}
+	
+	this->_unlockTx();
+	
+	if((space != 0) && (this->_tx_ready_func != NULL))
+	{
+		this->_tx_ready_func(space);
+	}
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_TX_QUEUE
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::_drainTx(void)
+{
+	uint16_t pos, cnt;
+	uint8_t space = this->_hw()->_availableTxBuffer(); //Only what fits right now, so the caller is never blocked
+	
+	while((this->_txq_head != this->_txq_tail) && (space != 0))
+	{
+		//Contiguous part of the queue
+		pos = this->_txq_tail & (MUCOM_TXQ_SIZE - 1);
+		cnt = this->_txq_head - this->_txq_tail;
+		if(cnt > (MUCOM_TXQ_SIZE - pos))
+		{
+			cnt = MUCOM_TXQ_SIZE - pos;
+		}
+		if(cnt > space)
+		{
+			cnt = space;
+		}
+		
+		MUCOM_CAPTURE(MUCOM_CAPTURE_TX, &this->_txq[pos], cnt);
+		this->_hw()->_write(&this->_txq[pos], cnt);
+		this->_txq_tail += cnt;
+		space -= cnt;
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::setTxQueue(uint8_t enable)
+{
+	uint32_t time_start = this->_hw()->_getTimestampUs();
+	uint8_t empty;
+	
+	if(((FEATURES & MUCOM_FEATURE_TX_QUEUE) == 0) && (enable != 0))
+	{
+		return MUCOM_ERR;
+	}
+	
+	//Queued frames are written before the queue is deactivated
+	do
+	{
+		this->_lockTxNoWait();
+		this->_drainTx();
+		empty = (this->_txq_head == this->_txq_tail) ? 1 : 0;
+		if(empty || (enable != 0))
+		{
+			this->_txq_active = (enable != 0) ? 1 : 0;
+			this->_unlockTx();
+			return MUCOM_OK;
+		}
+		this->_unlockTx();
+	} while((uint32_t)(this->_hw()->_getTimestampUs() - time_start) < this->_timeout);
+	
+	return MUCOM_ERR_TIMEOUT;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint16_t MUCOM_CORE::getTxQueueDepth(void)
+{
+	uint16_t depth;
+	
+	this->_lockTxNoWait();
+	depth = (uint16_t)(this->_txq_head - this->_txq_tail) + this->_txCollected();
+	this->_unlockTx();
+	
+	return depth;
+}
+#endif
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::_allocRead(uint16_t index, uint8_t *data, uint8_t size)
+{
+	int8_t tag;
+	
+	//Find a free slot for the request
+	for(tag = 0; tag < MUCOM_PENDING_SLOTS; tag++)
+	{
+		if(this->_pending[tag].data == NULL)
+		{
+			break;
+		}
+	}
+	
+	if(tag >= MUCOM_PENDING_SLOTS)
+	{
+		return MUCOM_ERR;
+	}
+	
+	this->_pending[tag].index = index;
+	this->_pending[tag].size = size;
+	this->_pending[tag].order = this->_pending_order++;
+	this->_pending[tag].status = MUCOM_PENDING;
+	this->_pending[tag].time_start = this->_hw()->_getTimestampUs();
+	this->_pending[tag].timeout = this->_readTimeout();
+	this->_pending[tag].reject = MUCOM_EXT_READ_REJECT;
+	this->_pending[tag].ambiguous = 0;
+	this->_pending[tag].data = data;
+	
+	return tag;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readAtAsync(uint16_t index, uint16_t offset, uint8_t *data, uint8_t size)
+{
+	uint8_t buf[2 + MUCOM_CRC_LEN];
+	int8_t tag;
+	
+	if((size == 0) || (size > 8) || (data == NULL))
+	{
+		return MUCOM_ERR;
+	}
+	
+	//Create first bytes with header and variable index
+	buf[0] = MUCOM_HEADER_BIT_MASK + MUCOM_READ_REQUEST + ((size - 1) << 2) + ((index & 0xFF) >> 6);
+	buf[1] = (index << 1) & 0x7F;
+	
+	if(this->_lockTx() != MUCOM_OK)
+	{
+		return MUCOM_ERR_TIMEOUT; //Timeout
+	}
+	
+	tag = this->_allocRead(index, data, size);
+	if(tag < 0)
+	{
+		this->_unlockTx();
+		return tag; //Too many requests in flight
+	}
+	
+	this->_sendPrefix(index, offset);
+	this->_send(buf, 2); //Send read variable request to slave
+	
+	this->_unlockTx();
+	
+	return tag;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readBatchAsync(const uint8_t *index, uint8_t * const *data, const uint8_t *cnt, uint8_t num, int8_t *tags)
+{
+	uint8_t buf[1 + MUCOM_EXT_MAX_ARGS];
+	uint8_t i, range = 1;
+	
+	if((num == 0) || (num > MUCOM_MAX_BATCH_READ))
+	{
+		return MUCOM_ERR;
+	}
+	
+	for(i = 0; i < num; i++)
+	{
+		if((cnt[i] == 0) || (cnt[i] > 8) || (data[i] == NULL))
+		{
+			return MUCOM_ERR;
+		}
+		if(index[i] != (uint8_t)(index[0] + i))
+		{
+			range = 0;
+		}
+	}
+	
+	//Create extended frame
+	if(range != 0)
+	{
+		buf[0] = MUCOM_EXT_READ_RANGE;
+		buf[1] = index[0];
+		buf[2] = num;
+		range = 3;
+	}
+	else if(num <= MUCOM_EXT_MAX_ARGS)
+	{
+		buf[0] = MUCOM_EXT_READ_LIST;
+		memcpy(buf + 1, index, num);
+		range = num + 1;
+	}
+	else
+	{
+		return MUCOM_ERR; //Too many indices for a list request
+	}
+	
+	//Reserve slots for all responses before sending the request
+	this->_hw()->_disableInterrupts();
+	for(i = 0; i < num; i++)
+	{
+		tags[i] = this->_allocRead(index[i], data[i], cnt[i]);
+		if(tags[i] < 0)
+		{
+			while(i != 0)
+			{
+				i--;
+				this->_pending[tags[i]].data = NULL;
+			}
+			this->_hw()->_enableInterrupts();
+			return MUCOM_ERR; //Too many requests in flight
+		}
+	}
+	this->_hw()->_enableInterrupts();
+	
+	this->writeRaw(MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, buf, range);
+	
+	return MUCOM_OK;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readBatch(const uint8_t *index, uint8_t * const *data, const uint8_t *cnt, uint8_t num)
+{
+	int8_t tags[MUCOM_MAX_BATCH_READ];
+	int8_t status, ret;
+	uint8_t i;
+	
+	//Flush receive buffer
+	this->handle();
+	
+	ret = this->readBatchAsync(index, data, cnt, num, tags);
+	if(ret != MUCOM_OK)
+	{
+		return ret;
+	}
+	
+	this->flush();
+	this->_hw()->_flushTx(); //Wait for all bytes to be transmitted
+	
+	//Receive all answers from slave with timeout
+	for(i = 0; i < num; i++)
+	{
+		while((status = this->readStatus(tags[i])) == MUCOM_PENDING)
+		{
+			this->handle();
+		}
+		if(status != MUCOM_OK)
+		{
+			ret = status;
+		}
+	}
+	
+	return ret;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readStatus(uint8_t tag)
+{
+	int8_t status;
+	
+	if((tag >= MUCOM_PENDING_SLOTS) || (this->_pending[tag].data == NULL))
+	{
+		return MUCOM_ERR;
+	}
+	
+	status = this->_pending[tag].status;
+	if(status == MUCOM_PENDING)
+	{
+		if((uint32_t)(this->_hw()->_getTimestampUs() - this->_pending[tag].time_start) < this->_pending[tag].timeout)
+		{
+			return MUCOM_PENDING;
+		}
+		
+		//The response might have arrived meanwhile
+		this->_hw()->_disableInterrupts();
+		status = this->_pending[tag].status;
+		if(status == MUCOM_PENDING)
+		{
+			status = MUCOM_ERR_TIMEOUT; //Timeout
+			
+			//Unless its response may have been dropped already as the late response of an older request
+			if(this->_pending[tag].ambiguous == 0)
+			{
+				this->_addLate(tag);
+			}
+		}
+		this->_hw()->_enableInterrupts();
+		
+		if(status == MUCOM_ERR_TIMEOUT)
+		{
+			//Back off, the response might just be late
+			this->_rto = ((this->_rto * 2) < this->_timeout) ? (this->_rto * 2) : this->_timeout;
+			MUCOM_STATS(timeouts++);
+		}
+	}
+	
+	//Final result. Release slot
+	this->cancelRead(tag);
+	
+	return status;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+void MUCOM_CORE::cancelRead(uint8_t tag)
+{
+	if(tag < MUCOM_PENDING_SLOTS)
+	{
+		this->_hw()->_disableInterrupts();
+		this->_pending[tag].data = NULL;
+		this->_hw()->_enableInterrupts();
+	}
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::pendingReads(void)
+{
+	uint8_t i, cnt = 0;
+	
+	for(i = 0; i < MUCOM_PENDING_SLOTS; i++)
+	{
+		if((this->_pending[i].data != NULL) && (this->_pending[i].status == MUCOM_PENDING))
+		{
+			cnt++;
+		}
+	}
+	
+	return cnt;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::readAt(uint16_t index, uint16_t offset, uint8_t *data, uint8_t size)
+{
+	int8_t tag, status;
+	
+	//Flush receive buffer
+	this->handle();
+	
+	tag = this->readAtAsync(index, offset, data, size);
+	if(tag < 0)
+	{
+		return tag;
+	}
+	
+	this->flush();
+	this->_hw()->_flushTx(); //Wait for all bytes to be transmitted
+	
+	//Receive answer from slave with timeout
+	while((status = this->readStatus(tag)) == MUCOM_PENDING)
+	{
+		this->handle();
+	}
+	
+	return status;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint8_t MUCOM_CORE::readByte(uint16_t index)
+{
+	uint8_t data;
+	if(this->read(index, &data, sizeof(uint8_t)) != MUCOM_OK)
+	{
+		return 0xFF;
+	}
+	return data;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint16_t MUCOM_CORE::readShort(uint16_t index)
+{
+	uint16_t data;
+	if(this->read(index, (uint8_t*)&data, sizeof(uint16_t)) != MUCOM_OK)
+	{
+		return 0xFFFF;
+	}
+	return data;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint32_t MUCOM_CORE::readLong(uint16_t index)
+{
+	uint32_t data;
+	if(this->read(index, (uint8_t*)&data, sizeof(uint32_t)) != MUCOM_OK)
+	{
+		return 0xFFFFFFFF;
+	}
+	return data;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+uint64_t MUCOM_CORE::readLongLong(uint16_t index)
+{
+	uint64_t data;
+	if(this->read(index, (uint8_t*)&data, sizeof(uint64_t)) != MUCOM_OK)
+	{
+		return 0xFFFFFFFFFFFFFFFF;
+	}
+	return data;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+float MUCOM_CORE::readFloat(uint16_t index)
+{
+	float data;
+	if(this->read(index, (uint8_t*)&data, sizeof(float)) != MUCOM_OK)
+	{
+		return -1.0;
+	}
+	return data;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+double MUCOM_CORE::readDouble(uint16_t index)
+{
+	double data;
+	if(this->read(index, (uint8_t*)&data, sizeof(float)) != MUCOM_OK)
+	{
+		return -1.0;
+	}
+	return data;
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_RMW
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::modifyAsync(uint8_t index, uint8_t op, const uint8_t *operand, const uint8_t *compare, uint8_t *prev, uint8_t size)
+{
+	uint8_t buf[MUCOM_MAX_FRAME_LEN + MUCOM_CRC_LEN];
+	uint8_t data[3 + 4];
+	int8_t tag;
+	
+	if(((size != 1) && (size != 2) && (size != 4)) || (operand == NULL) || (prev == NULL) || ((op & ~MUCOM_RMW_SIGNED) > MUCOM_RMW_MAX))
+	{
+		return MUCOM_ERR;
+	}
+	if(((op & ~MUCOM_RMW_SIGNED) == MUCOM_RMW_CAS) && (compare == NULL))
+	{
+		return MUCOM_ERR;
+	}
+	
+	if(this->_lockTx() != MUCOM_OK)
+	{
+		return MUCOM_ERR_TIMEOUT; //Timeout
+	}
+	
+	//The response with the previous value is handled like a read response
+	tag = this->_allocRead(index, prev, size);
+	if(tag < 0)
+	{
+		this->_unlockTx();
+		return tag; //Too many requests in flight
+	}
+	this->_pending[tag].reject = MUCOM_EXT_RMW_REJECT;
+	
+	//The compare value precedes the request. Both frames are sent while the interface is locked
+	if((op & ~MUCOM_RMW_SIGNED) == MUCOM_RMW_CAS)
+	{
+		data[0] = MUCOM_EXT_RMW_ARG;
+		data[1] = index;
+		memcpy(data + 2, compare, size);
+		this->_send(buf, muCom_encodeFrame(buf, MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, data, size + 2));
+	}
+	data[0] = MUCOM_EXT_RMW;
+	data[1] = index;
+	data[2] = op;
+	memcpy(data + 3, operand, size);
+	this->_send(buf, muCom_encodeFrame(buf, MUCOM_EXECUTE_REQUEST, MUCOM_EXT_INDEX, data, size + 3));
+	
+	this->_unlockTx();
+	
+	return tag;
+}
+
+
+
+MUCOM_CORE_TEMPLATE
+int8_t MUCOM_CORE::modify(uint8_t index, uint8_t op, const uint8_t *operand, const uint8_t *compare, uint8_t *prev, uint8_t size)
+{
+	int8_t tag, status;
+	
+	//Flush receive buffer
+	this->handle();
+	
+	tag = this->modifyAsync(index, op, operand, compare, prev, size);
+	if(tag < 0)
+	{
+		return tag;
+	}
+	
+	this->flush();
+	this->_hw()->_flushTx(); //Wait for all bytes to be transmitted
+	
+	//Receive answer with the previous value with timeout
+	while((status = this->readStatus(tag)) == MUCOM_PENDING)
+	{
+		this->handle();
+	}
+	
+	return status;
+}
+#endif
+
+
+
+#undef MUCOM_CORE_TEMPLATE
+#undef MUCOM_CORE
+#undef MUCOM_STATS
+#undef MUCOM_CAPTURE
+#undef MUCOM_FEATURE_SIZE
+#undef MUCOM_PENDING_SLOTS
+#undef MUCOM_SUB_SLOTS
+#undef MUCOM_CRC_SLOTS
+#undef MUCOM_RXQ_SLOTS
+#undef MUCOM_TXQ_SIZE
+#undef MUCOM_TXBUF_SIZE
+
+#endif //MUCOMCOREIMPL_H
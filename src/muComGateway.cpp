@@ -0,0 +1,548 @@
+#include "muComGateway.h"
+
+#if !defined(ARDUINO) && defined(__linux__)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+//epoll user data of the eventfd. All other events carry the ID of the link
+#define MUCOM_GATEWAY_WAKEUP	0xFFFFFFFF
+
+//Max. number of events processed per epoll_wait() call
+#define MUCOM_GATEWAY_EVENTS	32
+
+
+//State of a blocking read request (see muComGateway::read())
+struct muCom_GatewayWait_str
+{
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	uint8_t *data;
+	uint8_t done;
+	int8_t status;
+};
+
+
+
+static uint32_t muCom_gatewayTime(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+
+
+//Callback of blocking read requests
+static void muCom_gatewayWake(void *ctx, int16_t link, uint8_t index, int8_t status, uint8_t *data, uint8_t cnt)
+{
+	struct muCom_GatewayWait_str *wait = (struct muCom_GatewayWait_str*)ctx;
+
+	(void)link;
+	(void)index;
+
+	pthread_mutex_lock(&wait->lock);
+	if(status == MUCOM_OK)
+	{
+		memcpy(wait->data, data, cnt);
+	}
+	wait->status = status;
+	wait->done = 1;
+	pthread_cond_signal(&wait->cond);
+	pthread_mutex_unlock(&wait->lock);
+}
+
+
+
+muComGateway::muComGateway(uint8_t shards)
+{
+	struct epoll_event ev;
+	uint8_t i;
+	uint16_t k;
+
+	if(shards == 0)
+	{
+		shards = 1;
+	}
+	else if(shards > MUCOM_GATEWAY_MAX_SHARDS)
+	{
+		shards = MUCOM_GATEWAY_MAX_SHARDS;
+	}
+
+	this->_links_num = 0;
+	this->_running = 0;
+	this->_shards_num = shards;
+	this->_shards = new struct muCom_GatewayShard_str[shards];
+
+	for(i = 0; i < shards; i++)
+	{
+		struct muCom_GatewayShard_str *shard = &this->_shards[i];
+
+		shard->gateway = this;
+		shard->head = 0;
+		shard->tail = 0;
+		shard->inflight_num = 0;
+		for(k = 0; k < MUCOM_GATEWAY_QUEUE; k++)
+		{
+			shard->inflight[k].tag = -1; //Unused slot
+		}
+		pthread_mutex_init(&shard->lock, NULL);
+
+		//The eventfd wakes up the worker when other threads queue requests
+		shard->epfd = epoll_create1(EPOLL_CLOEXEC);
+		shard->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		memset(&ev, 0, sizeof(ev));
+		ev.events = EPOLLIN;
+		ev.data.u32 = MUCOM_GATEWAY_WAKEUP;
+		epoll_ctl(shard->epfd, EPOLL_CTL_ADD, shard->evfd, &ev);
+	}
+}
+
+
+
+muComGateway::~muComGateway()
+{
+	uint8_t i;
+
+	this->stop();
+
+	for(i = 0; i < this->_shards_num; i++)
+	{
+		close(this->_shards[i].evfd);
+		close(this->_shards[i].epfd);
+		pthread_mutex_destroy(&this->_shards[i].lock);
+	}
+	delete[] this->_shards;
+}
+
+
+
+int16_t muComGateway::addLink(muComBase *link, int fd, int16_t shard)
+{
+	struct epoll_event ev;
+	int16_t id = this->_links_num;
+
+	if((this->_running != 0) || (link == NULL) || (id >= MUCOM_GATEWAY_MAX_LINKS) || (shard >= this->_shards_num))
+	{
+		return MUCOM_ERR;
+	}
+
+	if(shard < 0)
+	{
+		shard = id % this->_shards_num; //Round robin
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u32 = (uint32_t)id;
+	if(epoll_ctl(this->_shards[shard].epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+	{
+		return MUCOM_ERR;
+	}
+
+	this->_links[id].link = link;
+	this->_links[id].fd = fd;
+	this->_links[id].shard = (uint8_t)shard;
+	this->_links_num++;
+
+	return id;
+}
+
+
+
+int8_t muComGateway::start(void)
+{
+	uint8_t i, k;
+
+	if(this->_running != 0)
+	{
+		return MUCOM_ERR;
+	}
+
+	this->_running = 1;
+	for(i = 0; i < this->_shards_num; i++)
+	{
+		this->_shards[i].last_tick = muCom_gatewayTime();
+		if(pthread_create(&this->_shards[i].thread, NULL, muComGateway::_worker, &this->_shards[i]) != 0)
+		{
+			//Stop the workers started so far and fail the requests queued meanwhile
+			this->_running = 0;
+			for(k = 0; k < this->_shards_num; k++)
+			{
+				if(k < i)
+				{
+					pthread_join(this->_shards[k].thread, NULL);
+				}
+				this->_cancel(&this->_shards[k]);
+			}
+			return MUCOM_ERR;
+		}
+	}
+
+	return MUCOM_OK;
+}
+
+
+
+void muComGateway::stop(void)
+{
+	uint64_t one = 1;
+	uint8_t i;
+
+	if(this->_running == 0)
+	{
+		return;
+	}
+
+	this->_running = 0;
+	for(i = 0; i < this->_shards_num; i++)
+	{
+		if(::write(this->_shards[i].evfd, &one, sizeof(one)) < 0)
+		{
+			//Worker wakes up with the next tick anyway
+		}
+		pthread_join(this->_shards[i].thread, NULL);
+		this->_cancel(&this->_shards[i]);
+	}
+}
+
+
+
+void *muComGateway::_worker(void *arg)
+{
+	struct muCom_GatewayShard_str *shard = (struct muCom_GatewayShard_str*)arg;
+	muComGateway *gw = shard->gateway;
+	uint8_t num = (uint8_t)(shard - gw->_shards);
+	struct epoll_event events[MUCOM_GATEWAY_EVENTS];
+	uint64_t cnt;
+	uint32_t now;
+	int16_t l;
+	int n, i;
+
+	while(gw->_running)
+	{
+		//Poll fast while read requests are waiting for their response to detect timeouts in time
+		n = epoll_wait(shard->epfd, events, MUCOM_GATEWAY_EVENTS, (shard->inflight_num != 0) ? 1 : MUCOM_GATEWAY_TICK);
+
+		for(i = 0; i < n; i++)
+		{
+			if(events[i].data.u32 == MUCOM_GATEWAY_WAKEUP)
+			{
+				if(::read(shard->evfd, &cnt, sizeof(cnt)) < 0)
+				{
+					//Nothing to do, the counter was already reset
+				}
+				continue;
+			}
+
+			l = (int16_t)events[i].data.u32;
+			if(events[i].events & (EPOLLHUP | EPOLLERR))
+			{
+				//Link is gone. Stop waiting for it, pending requests will time out
+				epoll_ctl(shard->epfd, EPOLL_CTL_DEL, gw->_links[l].fd, NULL);
+				continue;
+			}
+			gw->_links[l].link->handle();
+		}
+
+		gw->_processQueue(shard);
+
+		//Handle all links periodically for timeouts, bulk transfers and subscriptions
+		now = muCom_gatewayTime();
+		if((uint32_t)(now - shard->last_tick) >= MUCOM_GATEWAY_TICK)
+		{
+			shard->last_tick = now;
+			for(l = 0; l < gw->_links_num; l++)
+			{
+				if(gw->_links[l].shard == num)
+				{
+					gw->_links[l].link->handle();
+				}
+			}
+		}
+
+		gw->_processInflight(shard);
+	}
+
+	return NULL;
+}
+
+
+
+void muComGateway::_processQueue(struct muCom_GatewayShard_str *shard)
+{
+	struct muCom_GatewayRequest_str req;
+	struct muCom_GatewayRequest_str *slot;
+	muComBase *link;
+	uint16_t k;
+
+	pthread_mutex_lock(&shard->lock);
+	while(shard->tail != shard->head)
+	{
+		req = shard->queue[shard->tail];
+		shard->tail = (shard->tail + 1) % MUCOM_GATEWAY_QUEUE;
+
+		//Do not block other threads queueing requests while the link is accessed
+		pthread_mutex_unlock(&shard->lock);
+
+		link = this->_links[req.link].link;
+		switch(req.type)
+		{
+			case MUCOM_GATEWAY_WRITE:
+				link->write(req.index, req.data, req.cnt);
+				break;
+
+			case MUCOM_GATEWAY_INVOKE:
+				link->invokeFunction(req.index, req.data, req.cnt);
+				break;
+
+			case MUCOM_GATEWAY_READ:
+				//Find a free slot. The read data is stored in the slot itself
+				slot = NULL;
+				for(k = 0; k < MUCOM_GATEWAY_QUEUE; k++)
+				{
+					if(shard->inflight[k].tag < 0)
+					{
+						slot = &shard->inflight[k];
+						break;
+					}
+				}
+
+				if(slot == NULL)
+				{
+					req.callback(req.ctx, req.link, req.index, MUCOM_ERR, req.data, req.cnt);
+					break;
+				}
+
+				*slot = req;
+				slot->tag = link->readAsync(req.index, slot->data, req.cnt);
+				if(slot->tag < 0)
+				{
+					req.callback(req.ctx, req.link, req.index, slot->tag, req.data, req.cnt);
+					slot->tag = -1;
+					break;
+				}
+				shard->inflight_num++;
+				break;
+		}
+
+		pthread_mutex_lock(&shard->lock);
+	}
+	pthread_mutex_unlock(&shard->lock);
+}
+
+
+
+void muComGateway::_processInflight(struct muCom_GatewayShard_str *shard)
+{
+	struct muCom_GatewayRequest_str *slot;
+	uint16_t k;
+	int8_t status;
+
+	for(k = 0; (k < MUCOM_GATEWAY_QUEUE) && (shard->inflight_num != 0); k++)
+	{
+		slot = &shard->inflight[k];
+		if(slot->tag < 0)
+		{
+			continue;
+		}
+
+		status = this->_links[slot->link].link->readStatus((uint8_t)slot->tag);
+		if(status == MUCOM_PENDING)
+		{
+			continue;
+		}
+
+		slot->tag = -1;
+		shard->inflight_num--;
+		slot->callback(slot->ctx, slot->link, slot->index, status, slot->data, slot->cnt);
+	}
+}
+
+
+
+void muComGateway::_cancel(struct muCom_GatewayShard_str *shard)
+{
+	struct muCom_GatewayRequest_str req;
+	struct muCom_GatewayRequest_str *slot;
+	uint16_t k;
+
+	//The worker is gone, so nobody else accesses the links of the shard
+	for(k = 0; (k < MUCOM_GATEWAY_QUEUE) && (shard->inflight_num != 0); k++)
+	{
+		slot = &shard->inflight[k];
+		if(slot->tag < 0)
+		{
+			continue;
+		}
+
+		this->_links[slot->link].link->cancelRead((uint8_t)slot->tag);
+		slot->tag = -1;
+		shard->inflight_num--;
+		slot->callback(slot->ctx, slot->link, slot->index, MUCOM_ERR, slot->data, slot->cnt);
+	}
+
+	//Requests queued until the gateway was marked as stopped
+	pthread_mutex_lock(&shard->lock);
+	while(shard->tail != shard->head)
+	{
+		req = shard->queue[shard->tail];
+		shard->tail = (shard->tail + 1) % MUCOM_GATEWAY_QUEUE;
+		if(req.callback != NULL)
+		{
+			pthread_mutex_unlock(&shard->lock);
+			req.callback(req.ctx, req.link, req.index, MUCOM_ERR, req.data, req.cnt);
+			pthread_mutex_lock(&shard->lock);
+		}
+	}
+	pthread_mutex_unlock(&shard->lock);
+}
+
+
+
+int8_t muComGateway::_queue(struct muCom_GatewayRequest_str *req)
+{
+	struct muCom_GatewayShard_str *shard;
+	uint64_t one = 1;
+	uint16_t next;
+
+	if((req->link < 0) || (req->link >= this->_links_num) || (req->cnt == 0) || (req->cnt > 8))
+	{
+		return MUCOM_ERR;
+	}
+
+	shard = &this->_shards[this->_links[req->link].shard];
+
+	//Checked under the lock, so stop() either sees the request when cancelling the queue or the request sees the gateway stopped
+	pthread_mutex_lock(&shard->lock);
+	if(this->_running == 0)
+	{
+		pthread_mutex_unlock(&shard->lock);
+		return MUCOM_ERR; //No worker would ever execute the request
+	}
+	next = (shard->head + 1) % MUCOM_GATEWAY_QUEUE;
+	if(next == shard->tail)
+	{
+		pthread_mutex_unlock(&shard->lock);
+		return MUCOM_ERR; //Queue full
+	}
+	shard->queue[shard->head] = *req;
+	shard->head = next;
+	pthread_mutex_unlock(&shard->lock);
+
+	//Wake up the worker
+	if(::write(shard->evfd, &one, sizeof(one)) < 0)
+	{
+		//Counter overflow is impossible, the worker reads it with every wakeup
+	}
+
+	return MUCOM_OK;
+}
+
+
+
+int8_t muComGateway::readAsync(int16_t link, uint8_t index, uint8_t cnt, muComGatewayCallback callback, void *ctx)
+{
+	struct muCom_GatewayRequest_str req;
+
+	if(callback == NULL)
+	{
+		return MUCOM_ERR;
+	}
+
+	memset(&req, 0, sizeof(req));
+	req.callback = callback;
+	req.ctx = ctx;
+	req.link = link;
+	req.type = MUCOM_GATEWAY_READ;
+	req.index = index;
+	req.cnt = cnt;
+	req.tag = -1;
+
+	return this->_queue(&req);
+}
+
+
+
+int8_t muComGateway::read(int16_t link, uint8_t index, uint8_t *data, uint8_t cnt)
+{
+	struct muCom_GatewayWait_str wait;
+	int8_t ret;
+
+	pthread_mutex_init(&wait.lock, NULL);
+	pthread_cond_init(&wait.cond, NULL);
+	wait.data = data;
+	wait.done = 0;
+	wait.status = MUCOM_ERR;
+
+	ret = this->readAsync(link, index, cnt, muCom_gatewayWake, &wait);
+	if(ret == MUCOM_OK)
+	{
+		pthread_mutex_lock(&wait.lock);
+		while(wait.done == 0)
+		{
+			pthread_cond_wait(&wait.cond, &wait.lock);
+		}
+		pthread_mutex_unlock(&wait.lock);
+		ret = wait.status;
+	}
+
+	pthread_cond_destroy(&wait.cond);
+	pthread_mutex_destroy(&wait.lock);
+
+	return ret;
+}
+
+
+
+int8_t muComGateway::write(int16_t link, uint8_t index, const uint8_t *data, uint8_t cnt)
+{
+	struct muCom_GatewayRequest_str req;
+
+	if(cnt > 8)
+	{
+		return MUCOM_ERR;
+	}
+
+	req.callback = NULL;
+	req.ctx = NULL;
+	req.link = link;
+	req.type = MUCOM_GATEWAY_WRITE;
+	req.index = index;
+	req.cnt = cnt;
+	req.tag = -1;
+	memcpy(req.data, data, cnt);
+
+	return this->_queue(&req);
+}
+
+
+
+int8_t muComGateway::invokeFunction(int16_t link, uint8_t index, const uint8_t *data, uint8_t cnt)
+{
+	struct muCom_GatewayRequest_str req;
+
+	if(cnt > 8)
+	{
+		return MUCOM_ERR;
+	}
+
+	req.callback = NULL;
+	req.ctx = NULL;
+	req.link = link;
+	req.type = MUCOM_GATEWAY_INVOKE;
+	req.index = index;
+	req.cnt = cnt;
+	req.tag = -1;
+	memcpy(req.data, data, cnt);
+
+	return this->_queue(&req);
+}
+
+
+#endif //Linux host
@@ -0,0 +1,237 @@
+/**
+	\brief		Gateway driving many muCom links from a few worker threads (Linux only)
+	\details	Each link is assigned to a shard. Every shard is served by one worker thread waiting for received data of all its links via epoll,
+				so no thread is blocked by a single link. Requests of other threads are queued to the shard of the link and answered via callbacks.
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMGATEWAY_H
+#define MUCOMGATEWAY_H
+
+#include "muComBase.h"
+
+#if !defined(ARDUINO) && defined(__linux__)
+
+#include <pthread.h>
+
+//Max. number of links handled by a gateway
+#ifndef MUCOM_GATEWAY_MAX_LINKS
+	#define MUCOM_GATEWAY_MAX_LINKS		256
+#endif
+
+//Max. number of shards (worker threads) of a gateway
+#ifndef MUCOM_GATEWAY_MAX_SHARDS
+	#define MUCOM_GATEWAY_MAX_SHARDS	16
+#endif
+
+//Max. number of queued and in flight requests per shard
+#ifndef MUCOM_GATEWAY_QUEUE
+	#define MUCOM_GATEWAY_QUEUE			64
+#endif
+
+//Period in ms in which all links of a shard are handled without received data, e.g. for timeouts and subscriptions
+#ifndef MUCOM_GATEWAY_TICK
+	#define MUCOM_GATEWAY_TICK			10
+#endif
+
+//Request types
+#define MUCOM_GATEWAY_READ			0
+#define MUCOM_GATEWAY_WRITE			1
+#define MUCOM_GATEWAY_INVOKE		2
+
+
+/**
+	\brief		Function prototype for functions receiving the result of a read request sent via muComGateway::readAsync()
+	\details	The function is called from the worker thread of the link and must not block.
+	\param[in]	ctx		Context pointer passed to readAsync()
+	\param[in]	link	ID of the link
+	\param[in]	index	Index of the remote variable
+	\param[in]	status	See muCom error codes (0 = OK, <0 = Error)
+	\param[in]	data	Read data (only valid while the function is executed)
+	\param[in]	cnt		Number of data bytes
+*/
+typedef void (*muComGatewayCallback)(void *ctx, int16_t link, uint8_t index, int8_t status, uint8_t *data, uint8_t cnt);
+
+
+/**
+	\brief	Internal structure to store a request routed to a link
+*/
+struct muCom_GatewayRequest_str
+{
+	muComGatewayCallback callback;	//Function receiving the result of a read request
+	void *ctx;						//Context pointer passed to the callback
+	int16_t link;					//ID of the link
+	uint8_t type;					//MUCOM_GATEWAY_READ, MUCOM_GATEWAY_WRITE or MUCOM_GATEWAY_INVOKE
+	uint8_t index;					//Index of the remote variable or function
+	uint8_t cnt;					//Number of data bytes
+	int8_t tag;						//Tag of the read request at the link
+	uint8_t data[8];				//Data to be written or read data
+};
+
+
+/**
+	\brief	Internal structure to store a link of the gateway
+*/
+struct muCom_GatewayLink_str
+{
+	muComBase *link;				//muCom interface
+	int fd;							//File descriptor the interface reads from
+	uint8_t shard;					//Shard serving this link
+};
+
+
+/**
+	\brief	Internal structure to store the state of a shard
+*/
+struct muCom_GatewayShard_str
+{
+	class muComGateway *gateway;	//Gateway owning the shard
+	pthread_t thread;				//Worker thread
+	pthread_mutex_t lock;			//Lock of the request queue
+	int epfd;						//epoll instance waiting for all links of the shard
+	int evfd;						//eventfd waking up the worker when requests are queued
+	uint16_t head, tail;			//Request queue filled by other threads
+	struct muCom_GatewayRequest_str queue[MUCOM_GATEWAY_QUEUE];
+	uint16_t inflight_num;			//Number of read requests waiting for their response
+	struct muCom_GatewayRequest_str inflight[MUCOM_GATEWAY_QUEUE];
+	uint32_t last_tick;				//Timestamp of the last time all links were handled
+};
+
+
+/**
+	\brief		Gateway for many muCom links on a Linux host
+	\details	Links are added before start() and assigned to the shards round robin or explicitly. From then on only the worker thread of its shard
+				accesses a link. Other threads send requests via readAsync(), read(), write() and invokeFunction() which are queued to the shard.
+				The links must not be used directly while the gateway is running. Requests are only accepted while the gateway is running.
+*/
+class muComGateway
+{
+	private:
+		struct muCom_GatewayLink_str _links[MUCOM_GATEWAY_MAX_LINKS];	//All links
+		int16_t _links_num;												//Number of links
+		struct muCom_GatewayShard_str *_shards;							//All shards
+		uint8_t _shards_num;											//Number of shards
+		volatile uint8_t _running;										//1 while the worker threads are running
+
+		//Main loop of a worker thread
+		static void *_worker(void *arg);
+
+		//Execute all queued requests of a shard
+		void _processQueue(struct muCom_GatewayShard_str *shard);
+
+		//Pass all finished read requests of a shard to their callbacks
+		void _processInflight(struct muCom_GatewayShard_str *shard);
+
+		//Complete all queued and in-flight requests of a stopped shard with MUCOM_ERR
+		void _cancel(struct muCom_GatewayShard_str *shard);
+
+		//Queue a request to the shard of its link
+		int8_t _queue(struct muCom_GatewayRequest_str *req);
+
+	public:
+		/**
+			\brief		Constructor of the gateway
+			\param[in]	shards	Number of shards, i.e. worker threads (1..MUCOM_GATEWAY_MAX_SHARDS)
+		*/
+		explicit muComGateway(uint8_t shards);
+
+		~muComGateway();
+
+
+		/**
+			\brief		Add a link to the gateway
+			\details	Links can only be added while the gateway is stopped. The interface and the file descriptor are not owned by the gateway.
+			\param[in]	link	muCom interface, e.g. a muComPosix object
+			\param[in]	fd		File descriptor the interface reads from
+			\param[in]	shard	Shard serving the link or -1 to distribute the links round robin
+			\return		ID of the link (>= 0) to be used for requests
+						<br>See muCom error codes in case of errors (< 0)
+		*/
+		int16_t addLink(muComBase *link, int fd, int16_t shard = -1);
+
+
+		/**
+			\brief	Get the number of links
+			\return	Number of links
+		*/
+		inline int16_t getLinkCount(void)
+			{	return this->_links_num;	}
+
+
+		/**
+			\brief		Get the shard serving a link
+			\param[in]	link	ID of the link
+			\return		Shard of the link
+		*/
+		inline uint8_t getShard(int16_t link)
+			{	return this->_links[link].shard;	}
+
+
+		/**
+			\brief	Start the worker threads
+			\return	MUCOM_OK if all is alright
+		*/
+		int8_t start(void);
+
+
+		/**
+			\brief		Stop the worker threads
+			\details	Read requests which are still queued or waiting for their response are passed to their callbacks with MUCOM_ERR,
+						queued write requests and function invocations are dropped. Blocked read() calls return MUCOM_ERR.
+		*/
+		void stop(void);
+
+
+		/**
+			\brief		Send a read request via a link without waiting for the response
+			\details	The result is passed to the callback from the worker thread of the link.
+			\param[in]	link		ID of the link
+			\param[in]	index		Index of the remote variable to be read
+			\param[in]	cnt			Number of data bytes to read (1..8)
+			\param[in]	callback	Function receiving the result
+			\param[in]	ctx			Context pointer passed to the callback
+			\return		MUCOM_OK if the request was queued
+		*/
+		int8_t readAsync(int16_t link, uint8_t index, uint8_t cnt, muComGatewayCallback callback, void *ctx);
+
+
+		/**
+			\brief		Read data via a link and wait for the result
+			\details	Must not be called from a callback as it blocks the calling thread until the worker thread received the response.
+			\param[in]	link	ID of the link
+			\param[in]	index	Index of the remote variable to be read
+			\param[out]	data	Array to store the contents of the remote variable
+			\param[in]	cnt		Number of data bytes to read (1..8)
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		int8_t read(int16_t link, uint8_t index, uint8_t *data, uint8_t cnt);
+
+
+		/**
+			\brief		Write data to a remote variable via a link
+			\param[in]	link	ID of the link
+			\param[in]	index	Index of the remote variable to be written to
+			\param[in]	data	Data to be written
+			\param[in]	cnt		Number of data bytes (1..8)
+			\return		MUCOM_OK if the request was queued
+		*/
+		int8_t write(int16_t link, uint8_t index, const uint8_t *data, uint8_t cnt);
+
+
+		/**
+			\brief		Invoke a function at the communication partner of a link
+			\param[in]	link	ID of the link
+			\param[in]	index	Index of the function to be invoked
+			\param[in]	data	Parameter data of the function
+			\param[in]	cnt		Number of data bytes (1..8)
+			\return		MUCOM_OK if the request was queued
+		*/
+		int8_t invokeFunction(int16_t link, uint8_t index, const uint8_t *data, uint8_t cnt);
+};
+
+
+#endif //Linux host
+
+#endif //MUCOMGATEWAY_H
@@ -0,0 +1,609 @@
+#include "muComPosix.h"
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MUCOM_TABLE_FILE_MAGIC		0x5443756D	//"muCT"
+#define MUCOM_TABLE_FILE_VERSION	1
+
+
+//Header of a file caching a table
+struct muCom_TableFile_str
+{
+	uint32_t magic;
+	uint16_t version;
+	uint16_t size;			//Size of the table structure
+};
+
+
+//Linux supports arbitrary baudrates via the termios2 interface which can not be included together with termios.h
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__) || defined(__arm__) || defined(__aarch64__) || defined(__riscv))
+	#define MUCOM_POSIX_TERMIOS2
+
+	struct muCom_termios2
+	{
+		tcflag_t c_iflag;
+		tcflag_t c_oflag;
+		tcflag_t c_cflag;
+		tcflag_t c_lflag;
+		cc_t c_line;
+		cc_t c_cc[19];
+		speed_t c_ispeed;
+		speed_t c_ospeed;
+	};
+
+	#define MUCOM_TCGETS2	_IOR('T', 0x2A, struct muCom_termios2)
+	#define MUCOM_TCSETS2	_IOW('T', 0x2B, struct muCom_termios2)
+	#define MUCOM_CBAUD		0x0000100F
+	#define MUCOM_BOTHER	0x00001000
+#endif
+
+
+
+muComPosixTransport::muComPosixTransport(int fd)
+{
+	pthread_mutexattr_t attr;
+
+	this->_fd = fd;
+	this->_isTty = isatty(fd) ? 1 : 0;
+
+	//Recursive, as e.g. a linked function may write to the interface while handle() is being executed
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&this->_lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+
+
+muComPosixTransport::~muComPosixTransport()
+{
+	pthread_mutex_destroy(&this->_lock);
+}
+
+
+
+void muComPosixTransport::_write(uint8_t* data, uint8_t cnt)
+{
+	ssize_t ret;
+	struct pollfd pfd;
+
+	while(cnt != 0)
+	{
+		ret = ::write(this->_fd, data, cnt);
+		if(ret > 0)
+		{
+			data += ret;
+			cnt -= (uint8_t)ret;
+			continue;
+		}
+
+		if((ret < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+
+		if((ret < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+		{
+			//Non-blocking file descriptor with a full buffer. Wait until data can be written again
+			pfd.fd = this->_fd;
+			pfd.events = POLLOUT;
+			poll(&pfd, 1, -1);
+			continue;
+		}
+
+		return; //Error! Frame is lost just like with a disconnected UART
+	}
+}
+
+
+
+uint8_t muComPosixTransport::_read(void)
+{
+	uint8_t data;
+	ssize_t ret;
+
+	for(;;)
+	{
+		ret = ::read(this->_fd, &data, 1);
+		if(ret == 1)
+		{
+			return data;
+		}
+
+		if((ret < 0) && ((errno == EINTR) || (errno == EAGAIN)))
+		{
+			continue;
+		}
+
+		return 0xFF; //Error or end of file
+	}
+}
+
+
+
+uint16_t muComPosixTransport::_available(void)
+{
+	int cnt = 0;
+
+	if(ioctl(this->_fd, FIONREAD, &cnt) != 0)
+	{
+		return 0;
+	}
+
+	if(cnt > 0xFFFF)
+	{
+		return 0xFFFF;
+	}
+	return (uint16_t)cnt;
+}
+
+
+
+uint16_t muComPosixTransport::_readBuffer(uint8_t *data, uint16_t max)
+{
+	struct pollfd pfd;
+	ssize_t ret;
+
+	//Check for data without blocking, then fetch everything available with a single call
+	pfd.fd = this->_fd;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if((poll(&pfd, 1, 0) != 1) || ((pfd.revents & POLLIN) == 0))
+	{
+		return 0;
+	}
+
+	do
+	{
+		ret = ::read(this->_fd, data, max);
+	} while((ret < 0) && (errno == EINTR));
+
+	return (ret > 0) ? (uint16_t)ret : 0;
+}
+
+
+
+uint8_t muComPosixTransport::_availableTxBuffer(void)
+{
+	struct pollfd pfd;
+
+	//The kernel buffers are large compared to a muCom frame. Report a full buffer only if nothing can be written at all
+	pfd.fd = this->_fd;
+	pfd.events = POLLOUT;
+	pfd.revents = 0;
+	if((poll(&pfd, 1, 0) == 1) && (pfd.revents & POLLOUT))
+	{
+		return 0xFF;
+	}
+	return 0;
+}
+
+
+
+void muComPosixTransport::_flushTx(void)
+{
+	if(this->_isTty)
+	{
+		tcdrain(this->_fd);
+	}
+}
+
+
+
+uint32_t muComPosixTransport::_getTimestamp(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+
+
+uint32_t muComPosixTransport::_getTimestampUs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000);
+}
+
+
+
+//Configure a terminal for binary data transfer
+static int8_t muComPosix_makeRaw(int fd)
+{
+	struct termios tio;
+
+	if(tcgetattr(fd, &tio) != 0)
+	{
+		return MUCOM_ERR;
+	}
+
+	cfmakeraw(&tio);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+	tio.c_cc[VMIN] = 1;
+	tio.c_cc[VTIME] = 0;
+
+	if(tcsetattr(fd, TCSANOW, &tio) != 0)
+	{
+		return MUCOM_ERR;
+	}
+	return MUCOM_OK;
+}
+
+
+
+//Convert a baudrate to the termios constant. Returns 0 for non-standard baudrates
+static speed_t muComPosix_baudrate(uint32_t baudrate)
+{
+	switch(baudrate)
+	{
+		case 1200:		return B1200;
+		case 2400:		return B2400;
+		case 4800:		return B4800;
+		case 9600:		return B9600;
+		case 19200:		return B19200;
+		case 38400:		return B38400;
+		case 57600:		return B57600;
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		#ifdef B460800
+			case 460800:	return B460800;
+		#endif
+		#ifdef B500000
+			case 500000:	return B500000;
+		#endif
+		#ifdef B921600
+			case 921600:	return B921600;
+		#endif
+		#ifdef B1000000
+			case 1000000:	return B1000000;
+		#endif
+		#ifdef B2000000
+			case 2000000:	return B2000000;
+		#endif
+		#ifdef B3000000
+			case 3000000:	return B3000000;
+		#endif
+		#ifdef B4000000
+			case 4000000:	return B4000000;
+		#endif
+		default:		return 0;
+	}
+}
+
+
+
+int muComPosix::openSerial(const char *path, uint32_t baudrate)
+{
+	int fd;
+	struct termios tio;
+	speed_t speed;
+
+	fd = open(path, O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if(fd < 0)
+	{
+		return -1;
+	}
+
+	if(muComPosix_makeRaw(fd) != MUCOM_OK)
+	{
+		close(fd);
+		return -1;
+	}
+
+	speed = muComPosix_baudrate(baudrate);
+	if(speed != 0)
+	{
+		//Standard baudrate
+		if((tcgetattr(fd, &tio) != 0)
+			|| (cfsetispeed(&tio, speed) != 0)
+			|| (cfsetospeed(&tio, speed) != 0)
+			|| (tcsetattr(fd, TCSANOW, &tio) != 0))
+		{
+			close(fd);
+			return -1;
+		}
+	}
+	else
+	{
+		#ifdef MUCOM_POSIX_TERMIOS2
+			//Non-standard baudrate
+			struct muCom_termios2 tio2;
+
+			if(ioctl(fd, MUCOM_TCGETS2, &tio2) != 0)
+			{
+				close(fd);
+				return -1;
+			}
+			tio2.c_cflag &= ~MUCOM_CBAUD;
+			tio2.c_cflag |= MUCOM_BOTHER;
+			tio2.c_ispeed = baudrate;
+			tio2.c_ospeed = baudrate;
+			if(ioctl(fd, MUCOM_TCSETS2, &tio2) != 0)
+			{
+				close(fd);
+				return -1;
+			}
+		#else
+			close(fd);
+			return -1;
+		#endif
+	}
+
+	//Discard anything received before the port was configured
+	tcflush(fd, TCIOFLUSH);
+
+	return fd;
+}
+
+
+
+int8_t muComPosix::openPty(int *master, int *slave)
+{
+	int fd_master, fd_slave;
+	const char *name;
+
+	fd_master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(fd_master < 0)
+	{
+		return MUCOM_ERR;
+	}
+
+	if((grantpt(fd_master) != 0) || (unlockpt(fd_master) != 0) || ((name = ptsname(fd_master)) == NULL))
+	{
+		close(fd_master);
+		return MUCOM_ERR;
+	}
+
+	fd_slave = open(name, O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if(fd_slave < 0)
+	{
+		close(fd_master);
+		return MUCOM_ERR;
+	}
+
+	//Both sides must pass binary data unmodified
+	if((muComPosix_makeRaw(fd_slave) != MUCOM_OK) || (muComPosix_makeRaw(fd_master) != MUCOM_OK))
+	{
+		close(fd_slave);
+		close(fd_master);
+		return MUCOM_ERR;
+	}
+
+	*master = fd_master;
+	*slave = fd_slave;
+
+	return MUCOM_OK;
+}
+
+
+
+muComPosix::muComPosix(int fd, struct muCom_LinkedVariable_str *var_buf, uint16_t num_var, struct muCom_LinkedFunction_str *func_buf, uint16_t num_func) : muComBase(var_buf, num_var, func_buf, num_func), _transport(fd)
+{
+#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+	this->_receiver_running = 0;
+#endif
+}
+
+
+
+muComPosix::~muComPosix()
+{
+#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+	if(this->_receiver_running)
+	{
+		this->_receiver_running = 0;
+		pthread_join(this->_receiver, NULL);
+	}
+#endif
+}
+
+
+
+int8_t muComPosix::openSocketPair(int *a, int *b)
+{
+	int fd[2];
+
+	if(socketpair(AF_UNIX, SOCK_STREAM, 0, fd) != 0)
+	{
+		return MUCOM_ERR;
+	}
+
+	*a = fd[0];
+	*b = fd[1];
+
+	return MUCOM_OK;
+}
+
+
+
+#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+int8_t muComPosix::startReceiver(void)
+{
+	if(this->_receiver_running)
+	{
+		return MUCOM_ERR;
+	}
+
+	if(this->setRxQueue(1) != MUCOM_OK)
+	{
+		return MUCOM_ERR;
+	}
+
+	this->_receiver_running = 1;
+	if(pthread_create(&this->_receiver, NULL, muComPosix::_receiverThread, this) != 0)
+	{
+		this->_receiver_running = 0;
+		this->setRxQueue(0);
+		return MUCOM_ERR;
+	}
+
+	return MUCOM_OK;
+}
+
+
+
+void muComPosix::stopReceiver(void)
+{
+	if(this->_receiver_running == 0)
+	{
+		return;
+	}
+
+	this->_receiver_running = 0;
+	pthread_join(this->_receiver, NULL);
+
+	//Execute the remaining frames before data is read by handle() again
+	this->handle();
+	this->setRxQueue(0);
+}
+
+
+
+void *muComPosix::_receiverThread(void *arg)
+{
+	muComPosix *self = (muComPosix*)arg;
+	uint8_t buf[MUCOM_RX_CHUNK];
+	struct pollfd pfd;
+	uint16_t space;
+	ssize_t ret;
+
+	pfd.fd = self->getFd();
+	pfd.events = POLLIN;
+
+	while(self->_receiver_running)
+	{
+		//Only read what the queue is able to take. The rest stays in the kernel buffer, which stops the sender once it is full
+		space = self->rxQueueSpace();
+		if(space == 0)
+		{
+			usleep(100); //Wait until handle() took frames from the queue
+			continue;
+		}
+		if(space > sizeof(buf))
+		{
+			space = sizeof(buf);
+		}
+
+		//Wake up regularly to check whether the thread shall be stopped
+		pfd.revents = 0;
+		if(poll(&pfd, 1, 10) != 1)
+		{
+			continue;
+		}
+
+		ret = ::read(pfd.fd, buf, space);
+		if(ret > 0)
+		{
+			self->receive(buf, (uint16_t)ret);
+		}
+		else if((ret == 0) || ((errno != EINTR) && (errno != EAGAIN)))
+		{
+			break; //End of file or error
+		}
+	}
+
+	return NULL;
+}
+#endif
+
+
+
+#ifndef MUCOM_DEACTIVATE_DISCOVERY
+int8_t muComPosix::discoverCached(const char *path, struct muCom_Table_str *table)
+{
+	uint32_t hash;
+	int8_t ret;
+
+	if(muComPosix::loadTable(path, table) == MUCOM_OK)
+	{
+		ret = this->readTableHash(&hash);
+		if(ret != MUCOM_OK)
+		{
+			return ret;
+		}
+		if(hash == table->hash)
+		{
+			return MUCOM_OK; //Table did not change
+		}
+	}
+
+	ret = this->discover(table);
+	if(ret == MUCOM_OK)
+	{
+		muComPosix::saveTable(path, table);
+	}
+
+	return ret;
+}
+
+
+
+int8_t muComPosix::saveTable(const char *path, const struct muCom_Table_str *table)
+{
+	struct muCom_TableFile_str header;
+	FILE *file;
+	int8_t ret = MUCOM_OK;
+
+	header.magic = MUCOM_TABLE_FILE_MAGIC;
+	header.version = MUCOM_TABLE_FILE_VERSION;
+	header.size = sizeof(struct muCom_Table_str);
+
+	file = fopen(path, "wb");
+	if(file == NULL)
+	{
+		return MUCOM_ERR;
+	}
+	if((fwrite(&header, sizeof(header), 1, file) != 1) || (fwrite(table, sizeof(struct muCom_Table_str), 1, file) != 1))
+	{
+		ret = MUCOM_ERR;
+	}
+	if(fclose(file) != 0)
+	{
+		ret = MUCOM_ERR;
+	}
+
+	return ret;
+}
+
+
+
+int8_t muComPosix::loadTable(const char *path, struct muCom_Table_str *table)
+{
+	struct muCom_TableFile_str header;
+	FILE *file;
+	int8_t ret = MUCOM_ERR;
+
+	file = fopen(path, "rb");
+	if(file == NULL)
+	{
+		return MUCOM_ERR;
+	}
+	if((fread(&header, sizeof(header), 1, file) == 1) && (header.magic == MUCOM_TABLE_FILE_MAGIC)
+		&& (header.version == MUCOM_TABLE_FILE_VERSION) && (header.size == sizeof(struct muCom_Table_str))
+		&& (fread(table, sizeof(struct muCom_Table_str), 1, file) == 1))
+	{
+		ret = MUCOM_OK;
+	}
+	fclose(file);
+
+	return ret;
+}
+#endif
+
+
+#endif //POSIX host
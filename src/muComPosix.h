@@ -0,0 +1,232 @@
+/**
+	\brief		File containing the main class and the transport for the muCom interface when being used on a POSIX host (Linux, macOS, ...)
+	\details	The class talks to any file descriptor, e.g. a serial port configured via termios, one side of a pseudo terminal pair
+				or one side of a socketpair for in-process loopback links.
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMPOSIX_H
+#define MUCOMPOSIX_H
+
+#include "muComBase.h"
+#include "muComStatic.h"
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+
+#include <pthread.h>
+
+#define MUCOM_POSIX_CREATE(name, fd, num_var, num_func)						\
+	struct muCom_LinkedVariable_str _##name##_var_buf[ num_var ];				\
+	struct muCom_LinkedFunction_str _##name##_func_buf[ num_func ];			\
+	muComPosix name(fd, _##name##_var_buf, num_var, _##name##_func_buf, num_func);
+
+
+/**
+	\brief		Transport for the muCom interface when being used on a POSIX host
+	\details	Implements the HW access via a file descriptor. Timestamps are taken from the monotonic clock
+				and the thread lock is implemented with a recursive mutex instead of masking interrupts.
+				The file descriptor is not owned by this class and has to be closed by the caller.
+				Used by muComPosix and as transport of muComStatic, e.g. muComStatic<muComPosixTransport, 8, 4> link(fd);
+*/
+class muComPosixTransport
+{
+	private:
+		int _fd;						//File descriptor used for communication
+		uint8_t _isTty;					//1 if the file descriptor is a terminal (serial port or pty)
+		pthread_mutex_t _lock;			//Lock replacing the interrupt masking of the microcontroller implementation
+
+		//The mutex must not be copied
+		muComPosixTransport(const muComPosixTransport&);
+		muComPosixTransport& operator=(const muComPosixTransport&);
+
+	public:
+		/**
+			\brief		Constructor of the POSIX transport
+			\param[in]	fd			Open file descriptor used for communication
+		*/
+		explicit muComPosixTransport(int fd);
+
+		~muComPosixTransport();
+
+		/**
+			\brief	Get the file descriptor used by this transport
+			\return	File descriptor
+		*/
+		inline int getFd(void)
+			{	return this->_fd;	}
+
+		//HW functions used by muComCore
+		void _write(uint8_t* data, uint8_t cnt);
+
+		uint8_t _read(void);
+
+		uint16_t _available(void);
+
+		uint16_t _readBuffer(uint8_t *data, uint16_t max);
+
+		uint8_t _availableTxBuffer(void);
+
+		void _flushTx(void);
+
+		uint32_t _getTimestamp(void);
+
+		uint32_t _getTimestampUs(void);
+
+		inline void _disableInterrupts(void)
+			{	pthread_mutex_lock(&this->_lock);	}
+
+		inline void _enableInterrupts(void)
+			{	pthread_mutex_unlock(&this->_lock);	}
+};
+
+
+/**
+	\brief		Main class for the muCom interface when being used on a POSIX host
+	\details	This class inherits all functions from the muCom base class (see muComBase)
+				and implements the HW access via a file descriptor (see muComPosixTransport).
+				The file descriptor is not owned by this class and has to be closed by the caller.
+*/
+class muComPosix : public muComBase
+{
+	private:
+		muComPosixTransport _transport;	//Actual HW access
+
+		inline void _write(uint8_t* data, uint8_t cnt)
+			{	this->_transport._write(data, cnt);	}
+
+		inline uint8_t _read(void)
+			{	return this->_transport._read();	}
+
+		inline uint8_t _available(void)
+			{	uint16_t cnt = this->_transport._available(); return (cnt > 0xFF) ? 0xFF : (uint8_t)cnt;	}
+
+		inline uint16_t _readBuffer(uint8_t *data, uint16_t max)
+			{	return this->_transport._readBuffer(data, max);	}
+
+		inline uint8_t _availableTxBuffer(void)
+			{	return this->_transport._availableTxBuffer();	}
+
+		inline void _flushTx(void)
+			{	this->_transport._flushTx();	}
+
+		inline uint32_t _getTimestamp(void)
+			{	return this->_transport._getTimestamp();	}
+
+		inline uint32_t _getTimestampUs(void)
+			{	return this->_transport._getTimestampUs();	}
+
+		inline void _disableInterrupts(void)
+			{	this->_transport._disableInterrupts();	}
+
+		inline void _enableInterrupts(void)
+			{	this->_transport._enableInterrupts();	}
+
+#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+		pthread_t _receiver;					//Reader thread passing received data to receive()
+		volatile uint8_t _receiver_running;		//1 while the reader thread is running
+
+		//Main loop of the reader thread
+		static void *_receiverThread(void *arg);
+#endif
+
+	public:
+		/**
+			\brief		Constructor of the POSIX muCom class
+			\param[in]	fd			Open file descriptor used for communication
+			\param[in]	var_buf		Fixed buffer for linked variables
+			\param[in]	num_var		Max. number of variables to be linked
+			\param[in]	func_buf	Fixed buffer for linked functions
+			\param[in]	num_func	Max. number of functions to be linked
+		*/
+		muComPosix(int fd, struct muCom_LinkedVariable_str *var_buf, uint16_t num_var, struct muCom_LinkedFunction_str *func_buf, uint16_t num_func);
+
+		~muComPosix();
+
+
+		/**
+			\brief	Get the file descriptor used by this interface
+			\return	File descriptor
+		*/
+		inline int getFd(void)
+			{	return this->_transport.getFd();	}
+
+
+		/**
+			\brief		Open and configure a serial port (8N1, raw mode, no flow control)
+			\details	Non-standard baudrates (e.g. 250000) are supported on Linux.
+			\param[in]	path		Path of the serial device, e.g. "/dev/ttyUSB0"
+			\param[in]	baudrate	Baudrate in bit/s
+			\return		File descriptor or -1 in case of errors
+		*/
+		static int openSerial(const char *path, uint32_t baudrate);
+
+		/**
+			\brief		Open a pseudo terminal pair in raw mode
+			\details	The slave side behaves like a serial port and may be handed to other processes via its name (see ptsname()).
+			\param[out]	master	File descriptor of the master side
+			\param[out]	slave	File descriptor of the slave side
+			\return		MUCOM_OK if all is alright
+		*/
+		static int8_t openPty(int *master, int *slave);
+
+		/**
+			\brief		Open a connected pair of sockets for in-process loopback links
+			\param[out]	a	File descriptor of the first side
+			\param[out]	b	File descriptor of the second side
+			\return		MUCOM_OK if all is alright
+		*/
+		static int8_t openSocketPair(int *a, int *b);
+
+#ifndef MUCOM_DEACTIVATE_RX_QUEUE
+		/**
+			\brief		Start a reader thread receiving all data of the file descriptor
+			\details	The thread waits for received data and passes it to receive() right away (see setRxQueue()),
+						so handle() only has to execute the queued frames. It reads no more than the queue is able to take (see rxQueueSpace()),
+						i.e. a full queue makes the sender wait instead of losing frames. The thread ends at the end of the file or on errors.
+			\return		MUCOM_OK if all is alright
+		*/
+		int8_t startReceiver(void);
+
+		/**
+			\brief	Stop the reader thread and read the data in handle() again
+		*/
+		void stopReceiver(void);
+#endif
+
+#ifndef MUCOM_DEACTIVATE_DISCOVERY
+		/**
+			\brief		Read the table of the communication partner or reuse a table stored in a file
+			\details	Only the hash of the table is read if the file contains a table with the same hash. Otherwise the whole table
+						is discovered and stored in the file, so reconnecting to known devices does not require a discovery.
+			\param[in]	path	Path of the file caching the table
+			\param[out]	table	Table of the communication partner
+			\return		See muCom error codes (0 = OK, <0 = Error)
+		*/
+		int8_t discoverCached(const char *path, struct muCom_Table_str *table);
+
+		/**
+			\brief		Store a table of a communication partner in a file
+			\details	The file starts with a header containing a version and the size of the table structure,
+						so files written with a different MUCOM_MAX_TABLE or layout are not loaded.
+			\param[in]	path	Path of the file
+			\param[in]	table	Table to be stored
+			\return		MUCOM_OK if all is alright
+		*/
+		static int8_t saveTable(const char *path, const struct muCom_Table_str *table);
+
+		/**
+			\brief		Load a table of a communication partner from a file written by saveTable()
+			\param[in]	path	Path of the file
+			\param[out]	table	Loaded table
+			\return		MUCOM_OK if all is alright
+		*/
+		static int8_t loadTable(const char *path, struct muCom_Table_str *table);
+#endif
+};
+
+
+#endif //POSIX host
+
+#endif //MUCOMPOSIX_H
@@ -0,0 +1,52 @@
+/**
+	\brief		Compile-time configured muCom interface
+	\details	This file includes a class template combining the muCom core with a transport class. The transport, the number of linked
+				variables and functions as well as the features are template parameters, so the HW functions are called without virtual dispatch
+				and the compiler is able to inline them and to remove deactivated features.
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMSTATIC_H
+#define MUCOMSTATIC_H
+
+//Required includes
+#include "muComCore.h"
+
+
+/**
+	\brief		Compile-time configured muCom class
+	\details	The transport class has to provide the HW functions listed in muComCore as public member functions,
+				e.g. muComSerialTransport (see muCom.h) or muComPosixTransport (see muComPosix.h).
+				The buffers for linked variables and functions are part of the object, i.e. no MUCOM_CREATE macro is required.
+	\tparam		Transport	Class implementing the HW functions
+	\tparam		NUM_VAR		Max. number of variables to be linked
+	\tparam		NUM_FUNC	Max. number of functions to be linked
+	\tparam		FEATURES	Combination of MUCOM_FEATURE_... flags. The buffers of deactivated features are not part of the object
+*/
+template<class Transport, uint16_t NUM_VAR, uint16_t NUM_FUNC, uint16_t FEATURES = MUCOM_FEATURES_DEFAULT>
+class muComStatic : public Transport, public muComCore<muComStatic<Transport, NUM_VAR, NUM_FUNC, FEATURES>, FEATURES>
+{
+	private:
+		struct muCom_LinkedVariable_str _var_buf[NUM_VAR];	//Buffer for linked variables
+		struct muCom_LinkedFunction_str _func_buf[NUM_FUNC];	//Buffer for linked functions
+
+		typedef muComCore<muComStatic<Transport, NUM_VAR, NUM_FUNC, FEATURES>, FEATURES> _core;
+
+	public:
+		/**
+			\brief		Constructor of the compile-time configured muCom class
+			\param[in]	arg		Argument passed to the constructor of the transport, e.g. the serial interface or the file descriptor
+		*/
+		template<typename T>
+		explicit muComStatic(T &arg) : Transport(arg), _core(this->_var_buf, NUM_VAR, this->_func_buf, NUM_FUNC)
+			{	}
+
+		template<typename T>
+		explicit muComStatic(const T &arg) : Transport(arg), _core(this->_var_buf, NUM_VAR, this->_func_buf, NUM_FUNC)
+			{	}
+};
+
+
+#endif //MUCOMSTATIC_H
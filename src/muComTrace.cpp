@@ -0,0 +1,434 @@
+#include "muComTrace.h"
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__)) && !defined(MUCOM_DEACTIVATE_CAPTURE)
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+//Number of bytes a record occupies within the trace file
+#define MUCOM_TRACE_RECORD_LEN(cnt)	(sizeof(struct muCom_TraceRecord_str) + (((size_t)(cnt) + MUCOM_TRACE_ALIGN - 1) & ~((size_t)MUCOM_TRACE_ALIGN - 1)))
+
+
+
+//Get the monotonic clock in us
+static uint64_t muComTrace_clock(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+
+
+muComTrace::muComTrace()
+{
+	this->_file = NULL;
+	this->_last = 0;
+	pthread_mutex_init(&this->_lock, NULL);
+}
+
+
+
+muComTrace::~muComTrace()
+{
+	this->close();
+	pthread_mutex_destroy(&this->_lock);
+}
+
+
+
+int8_t muComTrace::open(const char *path)
+{
+	struct muCom_TraceHeader_str header;
+	struct timeval tv;
+	FILE *file;
+
+	this->close();
+
+	gettimeofday(&tv, NULL);
+	memset(&header, 0, sizeof(header));
+	header.magic = MUCOM_TRACE_MAGIC;
+	header.version = MUCOM_TRACE_VERSION;
+	header.size = sizeof(header);
+	header.start = (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+
+	file = fopen(path, "wb");
+	if(file == NULL)
+	{
+		return MUCOM_ERR;
+	}
+	if(fwrite(&header, sizeof(header), 1, file) != 1)
+	{
+		fclose(file);
+		return MUCOM_ERR;
+	}
+
+	pthread_mutex_lock(&this->_lock);
+	this->_file = file;
+	this->_last = muComTrace_clock();
+	pthread_mutex_unlock(&this->_lock);
+
+	return MUCOM_OK;
+}
+
+
+
+int8_t muComTrace::close(void)
+{
+	int8_t ret = MUCOM_OK;
+
+	pthread_mutex_lock(&this->_lock);
+	if(this->_file != NULL)
+	{
+		if(ferror(this->_file))
+		{
+			ret = MUCOM_ERR;
+		}
+		if(fclose(this->_file) != 0)
+		{
+			ret = MUCOM_ERR;
+		}
+		this->_file = NULL;
+	}
+	pthread_mutex_unlock(&this->_lock);
+
+	return ret;
+}
+
+
+
+void muComTrace::flush(void)
+{
+	pthread_mutex_lock(&this->_lock);
+	if(this->_file != NULL)
+	{
+		fflush(this->_file);
+	}
+	pthread_mutex_unlock(&this->_lock);
+}
+
+
+
+void muComTrace::write(uint8_t type, const uint8_t *data, uint16_t cnt)
+{
+	static const uint8_t padding[MUCOM_TRACE_ALIGN] = {0};
+	struct muCom_TraceRecord_str record;
+	uint64_t delay;
+
+	pthread_mutex_lock(&this->_lock);
+	if(this->_file == NULL)
+	{
+		pthread_mutex_unlock(&this->_lock);
+		return;
+	}
+
+	//Longer delays are spread across the following records
+	delay = muComTrace_clock() - this->_last;
+	if(delay > 0xFFFFFFFF)
+	{
+		delay = 0xFFFFFFFF;
+	}
+	this->_last += delay;
+
+	record.delay = (uint32_t)delay;
+	record.cnt = cnt;
+	record.type = type;
+	record.reserved = 0;
+
+	//The stdio buffer collects the records, so the file is only written in large blocks
+	fwrite(&record, sizeof(record), 1, this->_file);
+	fwrite(data, 1, cnt, this->_file);
+	fwrite(padding, 1, MUCOM_TRACE_RECORD_LEN(cnt) - sizeof(record) - cnt, this->_file);
+	pthread_mutex_unlock(&this->_lock);
+}
+
+
+
+void muComTrace::capture(void *ctx, uint8_t type, const uint8_t *data, uint16_t cnt)
+{
+	((muComTrace*)ctx)->write(type, data, cnt);
+}
+
+
+
+muComTraceReader::muComTraceReader()
+{
+	this->_map = NULL;
+	this->_size = 0;
+}
+
+
+
+muComTraceReader::~muComTraceReader()
+{
+	this->close();
+}
+
+
+
+int8_t muComTraceReader::open(const char *path)
+{
+	const struct muCom_TraceHeader_str *header;
+	struct stat st;
+	void *map;
+	int fd;
+
+	this->close();
+
+	fd = ::open(path, O_RDONLY);
+	if(fd < 0)
+	{
+		return MUCOM_ERR;
+	}
+	if((fstat(fd, &st) != 0) || ((size_t)st.st_size < sizeof(struct muCom_TraceHeader_str)))
+	{
+		::close(fd);
+		return MUCOM_ERR;
+	}
+
+	//The mapping stays valid after closing the file descriptor
+	map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if(map == MAP_FAILED)
+	{
+		return MUCOM_ERR;
+	}
+
+	header = (const struct muCom_TraceHeader_str*)map;
+	if((header->magic != MUCOM_TRACE_MAGIC) || (header->version != MUCOM_TRACE_VERSION) || (header->size < sizeof(struct muCom_TraceHeader_str))
+		|| ((header->size % MUCOM_TRACE_ALIGN) != 0) || (header->size > (size_t)st.st_size))
+	{
+		munmap(map, (size_t)st.st_size);
+		return MUCOM_ERR;
+	}
+
+	this->_map = (const uint8_t*)map;
+	this->_size = (size_t)st.st_size;
+	return MUCOM_OK;
+}
+
+
+
+void muComTraceReader::close(void)
+{
+	if(this->_map != NULL)
+	{
+		munmap((void*)this->_map, this->_size);
+		this->_map = NULL;
+		this->_size = 0;
+	}
+}
+
+
+
+const struct muCom_TraceRecord_str *muComTraceReader::_record(size_t pos) const
+{
+	const struct muCom_TraceRecord_str *record;
+
+	//A record cut off at the end of the file was still being written when recording stopped
+	if((this->_map == NULL) || (pos + sizeof(struct muCom_TraceRecord_str) > this->_size))
+	{
+		return NULL;
+	}
+	record = (const struct muCom_TraceRecord_str*)(this->_map + pos);
+	if(pos + sizeof(struct muCom_TraceRecord_str) + record->cnt > this->_size)
+	{
+		return NULL;
+	}
+	return record;
+}
+
+
+
+const struct muCom_TraceRecord_str *muComTraceReader::first(void) const
+{
+	if(this->_map == NULL)
+	{
+		return NULL;
+	}
+	return this->_record(this->getHeader()->size);
+}
+
+
+
+const struct muCom_TraceRecord_str *muComTraceReader::next(const struct muCom_TraceRecord_str *record) const
+{
+	return this->_record((size_t)((const uint8_t*)record - this->_map) + MUCOM_TRACE_RECORD_LEN(record->cnt));
+}
+
+
+
+muComReplayTransport::muComReplayTransport(const muComTraceReader &reader)
+{
+	pthread_mutexattr_t attr;
+
+	this->_reader = &reader;
+	this->_realtime = 0;
+
+	//Recursive, as e.g. a linked function may write to the interface while handle() is being executed
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(&this->_lock, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	this->rewind();
+}
+
+
+
+muComReplayTransport::~muComReplayTransport()
+{
+	pthread_mutex_destroy(&this->_lock);
+}
+
+
+
+const struct muCom_TraceRecord_str *muComReplayTransport::_find(const struct muCom_TraceRecord_str *record, uint8_t type, uint64_t *time)
+{
+	if(record == NULL)
+	{
+		record = this->_reader->first();
+		*time = 0;
+	}
+	else
+	{
+		record = this->_reader->next(record);
+	}
+
+	//The delays of all records add up to the time, including the ones of other types
+	while(record != NULL)
+	{
+		*time += record->delay;
+		if((record->type == type) && (record->cnt != 0))
+		{
+			return record;
+		}
+		record = this->_reader->next(record);
+	}
+	return NULL;
+}
+
+
+
+uint64_t muComReplayTransport::_now(void)
+{
+	if(this->_realtime)
+	{
+		return muComTrace_clock() - this->_start;
+	}
+	return this->_clock;
+}
+
+
+
+void muComReplayTransport::rewind(void)
+{
+	this->_rx = this->_find(NULL, MUCOM_CAPTURE_RX, &this->_rx_time);
+	this->_tx = this->_find(NULL, MUCOM_CAPTURE_TX, &this->_tx_time);
+	this->_rx_pos = 0;
+	this->_tx_pos = 0;
+	this->_clock = 0;
+	this->_mismatches = 0;
+	this->_start = muComTrace_clock();
+}
+
+
+
+void muComReplayTransport::setRealtime(uint8_t enable)
+{
+	//Continue at the current position of the trace
+	this->_start = muComTrace_clock() - this->_clock;
+	this->_realtime = enable ? 1 : 0;
+}
+
+
+
+void muComReplayTransport::_write(uint8_t* data, uint8_t cnt)
+{
+	const uint8_t *expected;
+
+	while(cnt != 0)
+	{
+		if(this->_tx == NULL)
+		{
+			this->_mismatches += cnt; //More bytes than recorded
+			return;
+		}
+
+		expected = muComTraceReader::getData(this->_tx);
+		if(*data != expected[this->_tx_pos])
+		{
+			this->_mismatches++;
+		}
+		data++;
+		cnt--;
+
+		this->_tx_pos++;
+		if(this->_tx_pos >= this->_tx->cnt)
+		{
+			this->_tx = this->_find(this->_tx, MUCOM_CAPTURE_TX, &this->_tx_time);
+			this->_tx_pos = 0;
+		}
+	}
+}
+
+
+
+uint8_t muComReplayTransport::_read(void)
+{
+	uint8_t data;
+
+	if(this->_readBuffer(&data, 1) == 1)
+	{
+		return data;
+	}
+	return 0xFF; //End of the trace
+}
+
+
+
+uint16_t muComReplayTransport::_available(void)
+{
+	if((this->_rx == NULL) || (this->_realtime && (this->_now() < this->_rx_time)))
+	{
+		return 0;
+	}
+	return this->_rx->cnt - this->_rx_pos;
+}
+
+
+
+uint16_t muComReplayTransport::_readBuffer(uint8_t *data, uint16_t max)
+{
+	uint16_t cnt;
+
+	cnt = this->_available();
+	if(cnt > max)
+	{
+		cnt = max;
+	}
+	if(cnt == 0)
+	{
+		return 0;
+	}
+
+	//Bytes are passed in the chunks they were received in, so the interface sees the same timing at full speed
+	memcpy(data, muComTraceReader::getData(this->_rx) + this->_rx_pos, cnt);
+	this->_clock = this->_rx_time;
+	this->_rx_pos += cnt;
+	if(this->_rx_pos >= this->_rx->cnt)
+	{
+		this->_rx = this->_find(this->_rx, MUCOM_CAPTURE_RX, &this->_rx_time);
+		this->_rx_pos = 0;
+	}
+	return cnt;
+}
+
+
+#endif //POSIX host
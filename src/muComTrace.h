@@ -0,0 +1,274 @@
+/**
+	\brief		File containing the capture and replay of muCom traces when being used on a POSIX host (Linux, macOS, ...)
+	\details	A trace file starts with a header followed by records of the data passed to the capture function of an interface
+				(see muComCore::setCapture()). Records are only ever appended and are aligned to 4 bytes, so a trace can be mapped
+				into memory and analysed in place. A trace cut off by a crash is valid up to its last complete record.
+				Received bytes of a trace can be fed back through handle() of an interface linked like the recording one (see muComReplayTransport).
+	\version	1.0
+	\author		Kai Liebich
+*/
+
+
+#ifndef MUCOMTRACE_H
+#define MUCOMTRACE_H
+
+#include "muComCore.h"
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__)) && !defined(MUCOM_DEACTIVATE_CAPTURE)
+
+#include <stdio.h>
+#include <stddef.h>
+#include <pthread.h>
+
+#define MUCOM_TRACE_MAGIC		0x5254756D	//"muTR"
+#define MUCOM_TRACE_VERSION		1
+#define MUCOM_TRACE_ALIGN		4			//Alignment of all records within the file
+
+
+/**
+	\brief	Header at the start of a trace file
+*/
+struct muCom_TraceHeader_str
+{
+	uint32_t magic;			//MUCOM_TRACE_MAGIC
+	uint16_t version;		//MUCOM_TRACE_VERSION
+	uint16_t size;			//Size of this header, the first record starts right after it
+	uint64_t start;			//Wall clock time the recording was started at in us since 1970
+};
+
+
+/**
+	\brief	Header of a record within a trace file. The captured bytes follow right after it, padded to MUCOM_TRACE_ALIGN bytes
+*/
+struct muCom_TraceRecord_str
+{
+	uint32_t delay;			//Time since the previous record (or the start of the recording) in us
+	uint16_t cnt;			//Number of captured bytes
+	uint8_t type;			//MUCOM_CAPTURE_...
+	uint8_t reserved;
+};
+
+
+/**
+	\brief		Writer of trace files
+	\details	Pass capture() and the trace object to setCapture() of the interface to be recorded.
+				Records may be written from several threads, e.g. the reader thread of muComPosix and the thread sending data.
+*/
+class muComTrace
+{
+	private:
+		FILE *_file;					//Trace file or NULL if closed
+		uint64_t _last;					//Time of the last record in us
+		pthread_mutex_t _lock;			//Lock serialising records written by different threads
+
+		//The mutex must not be copied
+		muComTrace(const muComTrace&);
+		muComTrace& operator=(const muComTrace&);
+
+	public:
+		muComTrace();
+
+		~muComTrace();
+
+		/**
+			\brief		Create a new trace file. An existing file is overwritten
+			\param[in]	path	Path of the trace file
+			\return		MUCOM_OK if all is alright
+		*/
+		int8_t open(const char *path);
+
+		/**
+			\brief		Write all pending records and close the trace file
+			\return		MUCOM_OK if all records were written
+		*/
+		int8_t close(void);
+
+		/**
+			\brief	Write all pending records to the trace file, e.g. before analysing it while still recording
+		*/
+		void flush(void);
+
+		/**
+			\brief		Append a record to the trace file
+			\details	Nothing is written if the trace file is not open.
+			\param[in]	type	MUCOM_CAPTURE_... or a user defined type >= 0x80
+			\param[in]	data	Bytes to be recorded
+			\param[in]	cnt		Number of bytes
+		*/
+		void write(uint8_t type, const uint8_t *data, uint16_t cnt);
+
+		/**
+			\brief		Capture function to be passed to setCapture() of an interface together with the trace object
+			\param[in]	ctx		Trace object
+			\param[in]	type	MUCOM_CAPTURE_...
+			\param[in]	data	Captured bytes
+			\param[in]	cnt		Number of captured bytes
+		*/
+		static void capture(void *ctx, uint8_t type, const uint8_t *data, uint16_t cnt);
+};
+
+
+/**
+	\brief		Reader of trace files
+	\details	The file is mapped into memory, records point directly into the mapping and stay valid until the reader is closed.
+*/
+class muComTraceReader
+{
+	private:
+		const uint8_t *_map;			//Mapped trace file or NULL if closed
+		size_t _size;					//Size of the mapping in bytes
+
+		//Get the record at a position of the mapping or NULL if it is not complete
+		const struct muCom_TraceRecord_str *_record(size_t pos) const;
+
+		//The mapping must not be copied
+		muComTraceReader(const muComTraceReader&);
+		muComTraceReader& operator=(const muComTraceReader&);
+
+	public:
+		muComTraceReader();
+
+		~muComTraceReader();
+
+		/**
+			\brief		Map a trace file into memory
+			\param[in]	path	Path of the trace file
+			\return		MUCOM_OK if all is alright
+		*/
+		int8_t open(const char *path);
+
+		/**
+			\brief	Unmap the trace file
+		*/
+		void close(void);
+
+		/**
+			\brief	Get the header of the trace file
+			\return	Header or NULL if no trace file is open
+		*/
+		inline const struct muCom_TraceHeader_str *getHeader(void) const
+			{	return (const struct muCom_TraceHeader_str*)this->_map;	}
+
+		/**
+			\brief	Get the first record of the trace file
+			\return	Record or NULL if there is none
+		*/
+		const struct muCom_TraceRecord_str *first(void) const;
+
+		/**
+			\brief		Get the record following another one
+			\details	The time of a record is the sum of the delays of all records up to and including it.
+			\param[in]	record	Current record
+			\return		Next record or NULL at the end of the trace
+		*/
+		const struct muCom_TraceRecord_str *next(const struct muCom_TraceRecord_str *record) const;
+
+		/**
+			\brief		Get the captured bytes of a record
+			\param[in]	record	Record
+			\return		Captured bytes (record->cnt bytes)
+		*/
+		static inline const uint8_t *getData(const struct muCom_TraceRecord_str *record)
+			{	return (const uint8_t*)(record + 1);	}
+};
+
+
+/**
+	\brief		Transport feeding a trace back through handle() of an interface
+	\details	The received bytes of the trace are passed to the interface at full speed or at their original timing (see setRealtime()).
+				At full speed the timestamps follow the trace instead of the clock, so a replay runs the same way each time.
+				Bytes written by the interface are compared to the ones written while recording. Used as transport of muComStatic,
+				e.g. muComStatic<muComReplayTransport, 8, 4> replay(reader); with the variables and functions linked like when recording.
+*/
+class muComReplayTransport
+{
+	private:
+		const muComTraceReader *_reader;					//Trace being replayed
+		const struct muCom_TraceRecord_str *_rx;			//Current record of received bytes or NULL at the end of the trace
+		const struct muCom_TraceRecord_str *_tx;			//Current record of written bytes or NULL at the end of the trace
+		uint16_t _rx_pos, _tx_pos;							//Number of bytes already used of the records above
+		uint64_t _rx_time, _tx_time;						//Time of the records above in us since the start of the recording
+		uint64_t _start;									//Clock at the start of the replay in us
+		uint64_t _clock;									//Time of the last received bytes passed to the interface in us
+		uint8_t _realtime;									//1 to pass received bytes at their original timing
+		uint32_t _mismatches;								//Number of written bytes different from the trace
+		pthread_mutex_t _lock;								//Lock replacing the interrupt masking of the microcontroller implementation
+
+		//Get the next record of a type following a record (NULL to start at the beginning)
+		const struct muCom_TraceRecord_str *_find(const struct muCom_TraceRecord_str *record, uint8_t type, uint64_t *time);
+
+		//Get the time since the start of the replay in us
+		uint64_t _now(void);
+
+		//The mutex must not be copied
+		muComReplayTransport(const muComReplayTransport&);
+		muComReplayTransport& operator=(const muComReplayTransport&);
+
+	public:
+		/**
+			\brief		Constructor of the replay transport
+			\param[in]	reader		Open trace, has to stay open during the replay
+		*/
+		explicit muComReplayTransport(const muComTraceReader &reader);
+
+		~muComReplayTransport();
+
+		/**
+			\brief	Start the replay again from the beginning of the trace
+		*/
+		void rewind(void);
+
+		/**
+			\brief		Select the timing of the replay
+			\param[in]	enable	1 to pass received bytes at their original timing, 0 to pass them at full speed (default)
+		*/
+		void setRealtime(uint8_t enable);
+
+		/**
+			\brief	Check whether all received bytes of the trace were passed to the interface
+			\return	1 if the replay is done
+		*/
+		inline uint8_t done(void) const
+			{	return (this->_rx == NULL) ? 1 : 0;	}
+
+		/**
+			\brief		Get the number of written bytes which differ from the trace
+			\details	Bytes written after the end of the recorded ones are counted as well, missing bytes are not.
+			\return		Number of differing bytes
+		*/
+		inline uint32_t getMismatches(void) const
+			{	return this->_mismatches;	}
+
+		//HW functions used by muComCore
+		void _write(uint8_t* data, uint8_t cnt);
+
+		uint8_t _read(void);
+
+		uint16_t _available(void);
+
+		uint16_t _readBuffer(uint8_t *data, uint16_t max);
+
+		inline uint8_t _availableTxBuffer(void)
+			{	return 0xFF;	}
+
+		inline void _flushTx(void)
+			{	}
+
+		inline uint32_t _getTimestamp(void)
+			{	return (uint32_t)(this->_now() / 1000);	}
+
+		inline uint32_t _getTimestampUs(void)
+			{	return (uint32_t)this->_now();	}
+
+		inline void _disableInterrupts(void)
+			{	pthread_mutex_lock(&this->_lock);	}
+
+		inline void _enableInterrupts(void)
+			{	pthread_mutex_unlock(&this->_lock);	}
+};
+
+
+#endif //POSIX host
+
+
+#endif //MUCOMTRACE_H